@@ -0,0 +1,23 @@
+# Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+# https://github.com/michalsc
+#
+# This Source Code Form is subject to the terms of the
+# Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+# with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+set(GENFILTERS_SCRIPT ${CMAKE_CURRENT_LIST_DIR}/genfilters.cmake)
+
+function(generate_filters target)
+
+    add_custom_command(
+        OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/filters.h
+        COMMAND ${CMAKE_COMMAND} -DOUTPUT=${CMAKE_CURRENT_BINARY_DIR}/filters.h -P ${GENFILTERS_SCRIPT}
+        DEPENDS ${GENFILTERS_SCRIPT}
+        COMMENT "Generating scaling filter kernels."
+        VERBATIM
+    )
+
+    target_sources(${target} PRIVATE ${CMAKE_CURRENT_BINARY_DIR}/filters.h)
+    target_include_directories(${target} PRIVATE ${CMAKE_CURRENT_BINARY_DIR})
+
+endfunction(generate_filters)
@@ -0,0 +1,186 @@
+# Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+# https://github.com/michalsc
+#
+# This Source Code Form is subject to the terms of the
+# Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+# with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+# Script mode generator of EDID profiles for the TC358743 bridge, invoked as
+#   cmake -DOUTPUT=<header> -P genedid.cmake
+#
+# Every profile is a 256 byte EDID (base block and one CTA-861 extension) advertising a single
+# preferred timing, together with the capture size and CSI-2 data type Unicam has to use for it.
+# Everything except the detailed timing, monitor name and video data block is shared by all profiles.
+# Checksums of both blocks are computed here.
+
+# Profile: id, monitor name, pixel clock (10kHz), hactive, hblank, hsync offset, hsync width, vactive, vblank,
+# vsync offset, vsync width, VIC byte
+# VIC byte is the short video descriptor of the CTA block, bit 7 marks it native. Timings without a CTA
+# equivalent list the mandatory VIC 1 only, sources pick the preferred detailed timing then.
+set(PROFILES
+    "288p50,EDTV 288p50,1350,720,144,12,64,288,24,2,3,0x01"
+    "288p60,EDTV 288p60,1617,720,144,12,64,288,24,2,3,0x01"
+    "480p60,EDTV 480p,2700,720,138,16,62,480,45,9,6,0x82"
+    "576p50,EDTV 576p,2700,720,144,12,64,576,49,5,5,0xa5"
+    "576p60,EDTV 576p60,3240,720,144,12,64,576,49,5,5,0x01"
+    "720p50,HDTV 720p50,7425,1280,700,440,40,720,30,5,5,0x93"
+    "720p60,HDTV 720p60,7425,1280,370,110,40,720,30,5,5,0x84"
+)
+
+# Profile used when none is selected in the devicetree
+set(DEFAULT_PROFILE 576p50)
+
+# All profiles are captured as RGB888
+set(DATATYPE 0x24)
+set(BPP 24)
+
+set(ASCII " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~")
+
+# Header, vendor, version, basic parameters, chromaticity, no established and standard timings
+set(BASE_HEAD
+    0x00 0xff 0xff 0xff 0xff 0xff 0xff 0x00 0x05 0xd7 0x00 0x00 0x00 0x00 0x00 0x00
+    0xff 0x22 0x01 0x03 0x80 0x32 0x1f 0x78 0x07 0xee 0x95 0xa3 0x54 0x4c 0x99 0x26
+    0x0f 0x50 0x54 0x00 0x00 0x00 0x01 0x01 0x01 0x01 0x01 0x01 0x01 0x01 0x01 0x01
+    0x01 0x01 0x01 0x01 0x01 0x01
+)
+
+# Range limits: 23-240 Hz vertical, 15-255 kHz horizontal, 110 MHz pixel clock
+set(RANGE_LIMITS
+    0x00 0x00 0x00 0xfd 0x00 0x17 0xf0 0x0f 0xff 0x0b 0x00 0x0a 0x20 0x20 0x20 0x20 0x20 0x20
+)
+
+# HDMI and HDMI Forum vendor specific data blocks of the CTA extension
+set(CTA_VSDB
+    0x67 0x03 0x0c 0x00 0x00 0x00 0x11 0x16
+    0x67 0xd8 0x5d 0xc4 0x01 0x16 0x80
+)
+
+function(hex_bytes out)
+    set(bytes "")
+    foreach(byte IN LISTS ARGN)
+        math(EXPR byte "${byte}" OUTPUT_FORMAT HEXADECIMAL)
+        string(LENGTH "${byte}" len)
+        if (len EQUAL 3)
+            string(REPLACE "0x" "0x0" byte "${byte}")
+        endif()
+        list(APPEND bytes ${byte})
+    endforeach()
+    string(JOIN ", " line ${bytes})
+    set(${out} "${line}" PARENT_SCOPE)
+endfunction()
+
+# Append checksum byte so that the sum of all bytes of the block is 0 modulo 256
+function(append_checksum var)
+    set(sum 0)
+    foreach(byte IN LISTS ${var})
+        math(EXPR sum "${sum} + ${byte}")
+    endforeach()
+    math(EXPR sum "(256 - ${sum} % 256) % 256")
+    set(block ${${var}})
+    list(APPEND block ${sum})
+    set(${var} ${block} PARENT_SCOPE)
+endfunction()
+
+# Detailed timing descriptor, analog composite sync, no borders, image size of the base block
+function(timing_descriptor out clk hact hblank hso hsw vact vblank vso vsw)
+    math(EXPR b0 "${clk} & 0xff")
+    math(EXPR b1 "${clk} >> 8")
+    math(EXPR b2 "${hact} & 0xff")
+    math(EXPR b3 "${hblank} & 0xff")
+    math(EXPR b4 "((${hact} >> 8) << 4) | (${hblank} >> 8)")
+    math(EXPR b5 "${vact} & 0xff")
+    math(EXPR b6 "${vblank} & 0xff")
+    math(EXPR b7 "((${vact} >> 8) << 4) | (${vblank} >> 8)")
+    math(EXPR b8 "${hso} & 0xff")
+    math(EXPR b9 "${hsw} & 0xff")
+    math(EXPR b10 "((${vso} & 0xf) << 4) | (${vsw} & 0xf)")
+    math(EXPR b11 "((${hso} >> 8) << 6) | ((${hsw} >> 8) << 4) | ((${vso} >> 4) << 2) | (${vsw} >> 4)")
+    set(${out} ${b0} ${b1} ${b2} ${b3} ${b4} ${b5} ${b6} ${b7} ${b8} ${b9} ${b10} ${b11}
+        0xd8 0xac 0x00 0x00 0x00 0x00 PARENT_SCOPE)
+endfunction()
+
+# Monitor name descriptor, name terminated with a line feed and padded with spaces
+function(name_descriptor out name)
+    set(bytes 0x00 0x00 0x00 0xfc 0x00)
+    string(LENGTH "${name}" len)
+    math(EXPR last "${len} - 1")
+    foreach(i RANGE 0 ${last})
+        string(SUBSTRING "${name}" ${i} 1 c)
+        string(FIND "${ASCII}" "${c}" code)
+        math(EXPR code "${code} + 32")
+        list(APPEND bytes ${code})
+    endforeach()
+    if (len LESS 13)
+        list(APPEND bytes 0x0a)
+        math(EXPR len "${len} + 1")
+    endif()
+    while (len LESS 13)
+        list(APPEND bytes 0x20)
+        math(EXPR len "${len} + 1")
+    endwhile()
+    set(${out} ${bytes} PARENT_SCOPE)
+endfunction()
+
+set(CONTENT "/* Generated by cmake/genedid.cmake, do not edit */\n\n")
+string(APPEND CONTENT "static const struct EdidProfile edid_profiles[] = {\n")
+
+set(index 0)
+foreach(entry IN LISTS PROFILES)
+    string(REPLACE "," ";" profile "${entry}")
+    list(GET profile 0 id)
+    list(GET profile 1 name)
+    list(GET profile 2 clk)
+    list(GET profile 3 hact)
+    list(GET profile 4 hblank)
+    list(GET profile 5 hso)
+    list(GET profile 6 hsw)
+    list(GET profile 7 vact)
+    list(GET profile 8 vblank)
+    list(GET profile 9 vso)
+    list(GET profile 10 vsw)
+    list(GET profile 11 vic)
+
+    string(LENGTH "${name}" len)
+    if (len GREATER 13)
+        message(FATAL_ERROR "Monitor name '${name}' of EDID profile ${id} is longer than 13 characters")
+    endif()
+
+    timing_descriptor(dtd ${clk} ${hact} ${hblank} ${hso} ${hsw} ${vact} ${vblank} ${vso} ${vsw})
+    name_descriptor(mname "${name}")
+
+    set(base ${BASE_HEAD} ${dtd} ${RANGE_LIMITS} ${mname})
+    foreach(i RANGE 1 18)
+        list(APPEND base 0x00)
+    endforeach()
+    list(APPEND base 0x01)
+    append_checksum(base)
+
+    set(ext 0x02 0x03 0x16 0x00 0x41 ${vic} ${CTA_VSDB})
+    list(LENGTH ext len)
+    while (len LESS 127)
+        list(APPEND ext 0x00)
+        math(EXPR len "${len} + 1")
+    endwhile()
+    append_checksum(ext)
+
+    if (id STREQUAL DEFAULT_PROFILE)
+        set(default_index ${index})
+    endif()
+
+    string(APPEND CONTENT "    { \"${id}\", ${hact}, ${vact}, ${DATATYPE}, ${BPP}, {\n")
+    foreach(block base ext)
+        foreach(row RANGE 0 7)
+            math(EXPR first "${row} * 16")
+            list(SUBLIST ${block} ${first} 16 bytes)
+            hex_bytes(line ${bytes})
+            string(APPEND CONTENT "        ${line},\n")
+        endforeach()
+    endforeach()
+    string(APPEND CONTENT "    } },\n")
+
+    math(EXPR index "${index} + 1")
+endforeach()
+
+string(APPEND CONTENT "};\n\n#define EDID_DEFAULT ${default_index}\n#define EDID_COUNT ${index}\n")
+
+file(WRITE ${OUTPUT} "${CONTENT}")
@@ -0,0 +1,175 @@
+# Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+# https://github.com/michalsc
+#
+# This Source Code Form is subject to the terms of the
+# Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+# with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+# Script mode generator of HVS scaling kernels, invoked as
+#   cmake -DOUTPUT=<header> -P genfilters.cmake
+#
+# Every kernel is sampled at 16 points x = 2 - 2i/15, i = 0..15, scaled so that 1.0 becomes 255 and
+# packed as 9 bit two's complement values, three per word, in the same layout as compute_scaling_kernel()
+# uses at runtime. All arithmetic is integer with 8.24 fixed point, sin() is evaluated as Taylor series.
+
+set(ONE 16777216)
+set(HALF 8388608)
+set(TWO 33554432)
+set(PI 52707179)
+
+# sin(pi * x) for x >= 0
+function(sin_pi out x)
+    math(EXPR x "${x} % ${TWO}")
+    set(sign 1)
+    if (x GREATER_EQUAL ONE)
+        math(EXPR x "${x} - ${ONE}")
+        set(sign -1)
+    endif()
+    if (x GREATER HALF)
+        math(EXPR x "${ONE} - ${x}")
+    endif()
+
+    math(EXPR t "${PI} * ${x} / ${ONE}")
+    math(EXPR t2 "${t} * ${t} / ${ONE}")
+    set(term ${t})
+    set(sum ${t})
+    foreach(n RANGE 1 6)
+        math(EXPR term "(0 - (${term})) * ${t2} / ${ONE} / (2 * ${n} * (2 * ${n} + 1))")
+        math(EXPR sum "${sum} + (${term})")
+    endforeach()
+
+    math(EXPR sum "(${sum}) * (${sign})")
+    set(${out} ${sum} PARENT_SCOPE)
+endfunction()
+
+# Mitchell-Netravali family, B and C in fixed point
+function(mitchell out x b c)
+    math(EXPR x2 "${x} * ${x} / ${ONE}")
+    math(EXPR x3 "${x2} * ${x} / ${ONE}")
+    if (x LESS ONE)
+        math(EXPR a1 "12 * ${ONE} - 9 * ${b} - 6 * ${c}")
+        math(EXPR a2 "-18 * ${ONE} + 12 * ${b} + 6 * ${c}")
+        math(EXPR a3 "6 * ${ONE} - 2 * ${b}")
+        math(EXPR k "((${a1}) * ${x3} / ${ONE} + (${a2}) * ${x2} / ${ONE} + (${a3})) / 6")
+    elseif (x LESS TWO)
+        math(EXPR a1 "0 - ${b} - 6 * ${c}")
+        math(EXPR a2 "6 * ${b} + 30 * ${c}")
+        math(EXPR a3 "-12 * ${b} - 48 * ${c}")
+        math(EXPR a4 "8 * ${b} + 24 * ${c}")
+        math(EXPR k "((${a1}) * ${x3} / ${ONE} + (${a2}) * ${x2} / ${ONE} + (${a3}) * ${x} / ${ONE} + (${a4})) / 6")
+    else()
+        set(k 0)
+    endif()
+    set(${out} ${k} PARENT_SCOPE)
+endfunction()
+
+# sinc(x) * sinc(x / a). The HVS kernel spans two pixels, so Lanczos-3 is truncated there
+function(lanczos out x a)
+    if (x EQUAL 0)
+        set(${out} ${ONE} PARENT_SCOPE)
+        return()
+    endif()
+    math(EXPR support "${a} * ${ONE}")
+    if (x GREATER_EQUAL support)
+        set(${out} 0 PARENT_SCOPE)
+        return()
+    endif()
+    math(EXPR xa "${x} / ${a}")
+    sin_pi(s1 ${x})
+    sin_pi(s2 ${xa})
+    math(EXPR num "(${s1}) * (${s2}) / ${ONE}")
+    math(EXPR px "${PI} * ${x} / ${ONE}")
+    math(EXPR den "${px} * ${px} / ${ONE} / ${a}")
+    math(EXPR k "(${num}) * ${ONE} / ${den}")
+    set(${out} ${k} PARENT_SCOPE)
+endfunction()
+
+# Nearest neighbour with a linear edge of given width centered on the nearest neighbour cutoff
+function(soft_edge out x width)
+    math(EXPR lo "${ONE} - ${width} / 2")
+    math(EXPR hi "${ONE} + ${width} / 2")
+    if (x LESS_EQUAL lo)
+        set(k ${ONE})
+    elseif (x GREATER_EQUAL hi)
+        set(k 0)
+    else()
+        math(EXPR k "(${hi} - ${x}) * ${ONE} / ${width}")
+    endif()
+    set(${out} ${k} PARENT_SCOPE)
+endfunction()
+
+function(filter_value out filter x)
+    if (filter STREQUAL "nearest")
+        if (x LESS ONE)
+            set(k ${ONE})
+        else()
+            set(k 0)
+        endif()
+    elseif (filter STREQUAL "catmull-rom")
+        mitchell(k ${x} 0 ${HALF})
+    elseif (filter STREQUAL "b-spline")
+        mitchell(k ${x} ${ONE} 0)
+    elseif (filter STREQUAL "lanczos2")
+        lanczos(k ${x} 2)
+    elseif (filter STREQUAL "lanczos3")
+        lanczos(k ${x} 3)
+    elseif (filter STREQUAL "sharp-bilinear")
+        soft_edge(k ${x} ${HALF})
+    elseif (filter STREQUAL "area")
+        soft_edge(k ${x} ${ONE})
+    else()
+        set(k 0)
+    endif()
+
+    # Scale to 255 and round to nearest
+    if (k LESS 0)
+        math(EXPR v "0 - ((0 - (${k})) * 255 + ${HALF}) / ${ONE}")
+    else()
+        math(EXPR v "(${k} * 255 + ${HALF}) / ${ONE}")
+    endif()
+    set(${out} ${v} PARENT_SCOPE)
+endfunction()
+
+function(pack_filter out filter)
+    set(half 0 0 0 0 0 0)
+    foreach(i RANGE 0 15)
+        math(EXPR x "${TWO} * (15 - ${i}) / 15")
+        filter_value(v ${filter} ${x})
+        math(EXPR w "${i} / 3")
+        math(EXPR shift "9 * (${i} % 3)")
+        list(GET half ${w} word)
+        math(EXPR word "${word} | ((${v} & 0x1ff) << ${shift})")
+        list(REMOVE_AT half ${w})
+        list(INSERT half ${w} ${word})
+    endforeach()
+
+    list(GET half 5 word)
+    math(EXPR word "${word} | (${word} << 9)")
+    list(REMOVE_AT half 5)
+    list(APPEND half ${word})
+
+    set(line "")
+    foreach(word IN LISTS half)
+        math(EXPR word "${word}" OUTPUT_FORMAT HEXADECIMAL)
+        string(APPEND line "${word}, ")
+    endforeach()
+    set(${out} "${line}" PARENT_SCOPE)
+endfunction()
+
+# Order has to match UNICAM_FILTER_* in resources/unicam.h. Default and Mitchell-Netravali are
+# computed at runtime, their rows stay empty
+set(FILTERS default nearest mitchell catmull-rom b-spline lanczos2 lanczos3 sharp-bilinear area)
+
+set(CONTENT "/* Generated by cmake/genfilters.cmake, do not edit */\n\n")
+string(APPEND CONTENT "static const ULONG filter_kernels[][6] = {\n")
+foreach(filter IN LISTS FILTERS)
+    if (filter STREQUAL "default" OR filter STREQUAL "mitchell")
+        set(line "0, 0, 0, 0, 0, 0, ")
+    else()
+        pack_filter(line ${filter})
+    endif()
+    string(APPEND CONTENT "    { ${line}}, /* ${filter} */\n")
+endforeach()
+string(APPEND CONTENT "};\n")
+
+file(WRITE ${OUTPUT} "${CONTENT}")
@@ -9,7 +9,8 @@
 extern "C" {
 #endif
 
-#if defined(__INTELLISENSE__)
+/* Host build of tests/host passes arguments the usual way */
+#if defined(__INTELLISENSE__) || defined(UNICAM_HOST)
 #define REGARG(arg, reg) arg
 #else
 #define REGARG(arg, reg) arg asm(reg)
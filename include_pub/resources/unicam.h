@@ -9,12 +9,86 @@
 #define UNICAMB_SMOOTHING   1
 #define UNICAMB_SCALER      2
 #define UNICAMB_BOOT        4
+#define UNICAMB_WINDOW      5
 #define UNICAMB_PHASE       8
 
 #define UNICAMF_INTEGER     0x0001
 #define UNICAMF_SMOOTHING   0x0002
 #define UNICAMF_SCALER      0x000c
 #define UNICAMF_BOOT        0x0010
+#define UNICAMF_WINDOW      0x0020  /* Unicam writes only the crop rectangle to memory */
 #define UNICAMF_PHASE       0xff00
 
+/* Scaling filters for UnicamSetFilter() */
+#define UNICAM_FILTER_DEFAULT           0   /* Nearest or Mitchell-Netravali, selected by UNICAMF_SMOOTHING */
+#define UNICAM_FILTER_NEAREST           1
+#define UNICAM_FILTER_MITCHELL          2   /* B and C set with UnicamSetKernel() */
+#define UNICAM_FILTER_CATMULL_ROM       3
+#define UNICAM_FILTER_BSPLINE           4
+#define UNICAM_FILTER_LANCZOS2          5
+#define UNICAM_FILTER_LANCZOS3          6   /* Truncated to the two pixel support of the HVS */
+#define UNICAM_FILTER_SHARP_BILINEAR    7
+#define UNICAM_FILTER_AREA              8
+#define UNICAM_FILTER_COUNT             9
+
+/*
+    Returned by UnicamWaitFrame() if no frame ended within a few frame periods, 200ms before the
+    period is known. Frame sequence numbers never take this value.
+*/
+#define UNICAM_WAIT_TIMEOUT     0xffffffff
+
+/*
+    Frame timing statistics, all times in microseconds. Frame ends are seen when the vertical blank
+    interrupt polls the receiver, so each time is rounded up to the next vertical blank of the Amiga
+    display. Single periods are multiples of it, only the average over many frames follows the source.
+*/
+struct UnicamStats {
+    ULONG   us_Sequence;        /* Frame sequence number of the newest sample */
+    ULONG   us_Frames;          /* Number of frames the statistics are computed from */
+    ULONG   us_PeriodMin;       /* Time between consecutive frame ends */
+    ULONG   us_PeriodAvg;
+    ULONG   us_PeriodMax;
+    ULONG   us_Dropped;         /* Frames missing within the sampled window */
+};
+
+/* CSI-2 receiver error counters, each counts frames with the given error. Counters saturate */
+struct UnicamErrors {
+    ULONG   ue_CRC;             /* Payload CRC error */
+    ULONG   ue_SOT;             /* Start of transmission sync error */
+    ULONG   ue_Packet;          /* Packet boundary error */
+    ULONG   ue_Header;          /* Packet header ECC error */
+    ULONG   ue_Length;          /* Packet length error */
+    ULONG   ue_ImageOverflow;   /* Image FIFO overflow */
+    ULONG   ue_OutputOverflow;  /* Output FIFO overflow */
+    ULONG   ue_BufferOverflow;  /* Image buffer overflow */
+    ULONG   ue_Stalls;          /* Capture stalls recovered by the watchdog */
+    ULONG   ue_RecoveryLast;    /* Time from last frame before a stall to first frame after it, us */
+    ULONG   ue_RecoveryMax;
+};
+
+/* Pixel formats of UnicamGrabFrame(), byte order in memory */
+#define UNICAM_GRAB_RGB24       0   /* R, G, B */
+#define UNICAM_GRAB_BGR24       1   /* B, G, R */
+#define UNICAM_GRAB_ARGB32      2   /* 0xff, R, G, B */
+#define UNICAM_GRAB_BGRA32      3   /* B, G, R, 0xff */
+#define UNICAM_GRAB_RGB16       4   /* R5G6B5, big endian */
+#define UNICAM_GRAB_RGB16PC     5   /* R5G6B5, little endian */
+#define UNICAM_GRAB_COUNT       6
+
+/* Rectangle of the captured frame, in pixels of the full frame */
+struct UnicamRect {
+    UWORD   ur_X;
+    UWORD   ur_Y;
+    UWORD   ur_Width;
+    UWORD   ur_Height;
+};
+
+/*
+    Flags of UnicamGrabPlanar(). Colour index written to the planes is RGB332 for 8 planes, RGB222
+    for 6 and in general red, green and blue fields of (depth + 1) / 3, (depth + 2) / 3 and depth / 3
+    bits, red in the upper bits. With UNICAM_PLANARF_GREY it is the luminance.
+*/
+#define UNICAM_PLANARF_GREY     0x0001
+#define UNICAM_PLANARF_NOWAIT   0x0002  /* Do not wait for a frame end */
+
 #endif /* RESOURCES_UNICAM_H */
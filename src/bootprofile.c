@@ -0,0 +1,50 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+
+#include "unicam.h"
+
+#ifdef UNICAM_BOOT_PROFILE
+
+static const char * const phase_names[BOOT_PHASES] = {
+    "start",
+    "DT parse",
+    "mailbox",
+    "C790/RGA init",
+    "Unicam start",
+    "DL build",
+};
+
+/* Print time spent in every phase which was reached. Phases never reached have no stamp */
+void boot_profile_report(struct UnicamBase * UnicamBase)
+{
+    ULONG start = UnicamBase->u_BootStamp[BOOT_START];
+    ULONG last = start;
+
+    for (int i=1; i < BOOT_PHASES; i++)
+    {
+        ULONG stamp = UnicamBase->u_BootStamp[i];
+
+        if (stamp == 0)
+            continue;
+
+        bug("[unicam] Boot %-14s %7ld us\n", (ULONG)phase_names[i], stamp - last);
+        last = stamp;
+    }
+
+    bug("[unicam] Boot total          %7ld us\n", last - start);
+
+    if (UNICAM_BOOT_BUDGET != 0 && last - start > UNICAM_BOOT_BUDGET)
+    {
+        bug("[unicam] Boot budget of %ld us exceeded by %ld us\n", UNICAM_BOOT_BUDGET, last - start - UNICAM_BOOT_BUDGET);
+    }
+}
+
+#endif /* UNICAM_BOOT_PROFILE */
@@ -0,0 +1,139 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+#include <exec/memory.h>
+
+#include <proto/exec.h>
+
+#include "unicam.h"
+
+/*
+    Bytes per captured line. Lines are padded to u_StrideAlign bytes if set, so that every line starts
+    on a cache line or burst boundary for the consumers of the frame.
+*/
+ULONG unicam_line_stride(struct UnicamBase * UnicamBase, ULONG width, UBYTE bpp)
+{
+    ULONG stride = width * (bpp / 8);
+
+    if (UnicamBase->u_StrideAlign > 1)
+        stride = (stride + UnicamBase->u_StrideAlign - 1) & ~(ULONG)(UnicamBase->u_StrideAlign - 1);
+
+    return stride;
+}
+
+/* Size of one frame slot of the receive buffer, rounded up to a cache line */
+ULONG unicam_frame_slot(struct UnicamBase * UnicamBase, ULONG width, ULONG height, UBYTE bpp)
+{
+    return (unicam_line_stride(UnicamBase, width, bpp) * height + UNICAM_SLOT_ALIGN - 1) & ~(UNICAM_SLOT_ALIGN - 1);
+}
+
+/*
+    Make the receive buffer hold count frames of given size. A carve-out reserved in the devicetree
+    (unicam-mem) is used as it is, whatever its size. Otherwise the buffer is taken from Fast RAM and
+    replaced if it is too small, never shrunk. The block as returned by AllocMem is kept for freeing,
+    the receive buffer is its cache line aligned part. A replaced block is retired, not freed, since
+    capture or a display list may still use it. Returns FALSE if there is no buffer large enough, or
+    an earlier block is still retired.
+*/
+BOOL unicam_alloc_receive(struct UnicamBase * UnicamBase, ULONG width, ULONG height, UBYTE bpp, UBYTE count)
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+    ULONG size = unicam_frame_slot(UnicamBase, width, height, bpp) * (count ? count : 1);
+
+    if (UnicamBase->u_ReceiveBuffer != NULL && UnicamBase->u_ReceiveAlloc == NULL)
+        return size <= UnicamBase->u_ReceiveBufferSize;
+
+    if (UnicamBase->u_ReceiveBuffer != NULL && size <= UnicamBase->u_ReceiveBufferSize)
+        return TRUE;
+
+    unicam_release_retired(UnicamBase);
+    if (UnicamBase->u_ReceiveAlloc != NULL && UnicamBase->u_RetiredAlloc != NULL)
+        return FALSE;
+
+    /* Old buffer stays if there is no memory for the new one */
+    APTR block = AllocMem(size + UNICAM_SLOT_ALIGN - 1, MEMF_FAST);
+
+    if (block == NULL)
+        return FALSE;
+
+    if (UnicamBase->u_ReceiveAlloc != NULL)
+    {
+        UnicamBase->u_RetiredAlloc = UnicamBase->u_ReceiveAlloc;
+        UnicamBase->u_RetiredAllocSize = UnicamBase->u_ReceiveAllocSize;
+        UnicamBase->u_RetiredUnused = FALSE;
+    }
+
+    UnicamBase->u_ReceiveAlloc = block;
+    UnicamBase->u_ReceiveAllocSize = size + UNICAM_SLOT_ALIGN - 1;
+    UnicamBase->u_ReceiveBuffer = (APTR)(((ULONG)block + UNICAM_SLOT_ALIGN - 1) & ~(UNICAM_SLOT_ALIGN - 1));
+    UnicamBase->u_ReceiveBufferSize = size;
+
+    return TRUE;
+}
+
+/* Release receive buffer taken from Fast RAM, a devicetree carve-out stays */
+void unicam_free_receive(struct UnicamBase * UnicamBase)
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+
+    if (UnicamBase->u_ReceiveAlloc == NULL)
+        return;
+
+    FreeMem(UnicamBase->u_ReceiveAlloc, UnicamBase->u_ReceiveAllocSize);
+
+    UnicamBase->u_ReceiveAlloc = NULL;
+    UnicamBase->u_ReceiveAllocSize = 0;
+    UnicamBase->u_ReceiveBuffer = NULL;
+    UnicamBase->u_ReceiveBufferSize = 0;
+}
+
+static BOOL points_into(volatile ULONG *word, ULONG start, ULONG size)
+{
+    return word != NULL && (LE32(*word) & ~0xC0000000) - start < size;
+}
+
+/*
+    Free the retired receive buffer once neither capture nor a display list built by the resource
+    points into it. The HVS reads the display list every frame, so the block has to stay unused for
+    RETIRE_DELAY before it goes. Called from task context whenever capture state changes and by the
+    input mode monitor.
+*/
+void unicam_release_retired(struct UnicamBase * UnicamBase)
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+    ULONG start = (ULONG)UnicamBase->u_RetiredAlloc;
+    ULONG size = UnicamBase->u_RetiredAllocSize;
+
+    if (UnicamBase->u_RetiredAlloc == NULL)
+        return;
+
+    if ((UnicamBase->u_Running && (ULONG)UnicamBase->u_CaptureAddress - start < size) ||
+        points_into(UnicamBase->u_DLLastAddress, start, size) || points_into(UnicamBase->u_DLAddressWord, start, size))
+    {
+        UnicamBase->u_RetiredUnused = FALSE;
+        return;
+    }
+
+    if (!UnicamBase->u_RetiredUnused)
+    {
+        UnicamBase->u_RetiredUnused = TRUE;
+        UnicamBase->u_RetiredSince = systimer_read();
+        return;
+    }
+
+    if (systimer_read() - UnicamBase->u_RetiredSince < RETIRE_DELAY)
+        return;
+
+    FreeMem(UnicamBase->u_RetiredAlloc, UnicamBase->u_RetiredAllocSize);
+
+    UnicamBase->u_RetiredAlloc = NULL;
+    UnicamBase->u_RetiredAllocSize = 0;
+    UnicamBase->u_RetiredUnused = FALSE;
+}
@@ -1,4 +1,7 @@
 #include "unicam.h"
+#include "timer.h"
+#include "mbox.h"
+#include "i2c.h"
 
 // GPIO alternative functions ordered by pin function
 #define GPIO0_AF_I2C0_SDA GPIO_AF_0
@@ -61,12 +64,6 @@ typedef struct tGpioRegs {
     ULONG TEST;
 } tGpioRegs;
 
-static void busyWait(uint32_t ulCycles)
-{
-    volatile uint32_t i = ulCycles;
-    while(i--) continue;
-}
-
 void gpioSetPull(volatile tGpioRegs *pGpio, UBYTE ubIndex, tGpioPull ePull)
 {
     UBYTE ubRegIndex = ubIndex / 32;
@@ -74,9 +71,9 @@ void gpioSetPull(volatile tGpioRegs *pGpio, UBYTE ubIndex, tGpioPull ePull)
 
     // This is kinda like bitbanging of the pulse on the 2-lane bus
     wr32le(&pGpio->GPPUD, ePull);
-    busyWait(150);
+    timer_delay(1);
     wr32le(&pGpio->GPPUDCLK[ubRegIndex], 1 << ubRegShift);
-    busyWait(150);
+    timer_delay(1);
     wr32le(&pGpio->GPPUD, 0);
     wr32le(&pGpio->GPPUDCLK[ubRegIndex], 0);
 }
@@ -111,246 +108,339 @@ void gpioSetLevel(volatile tGpioRegs *pGpio, UBYTE ubIndex, UBYTE ubState)
     }
 }
 
-#define I2C_C_I2CEN (1 << 15) // I2C Enable
-#define I2C_C_INTR (1 <<  10) // Interrupt on RX
-#define I2C_C_INTT (1 << 9) // Interrupt on TX
-#define I2C_C_INTD (1 << 8) // Interrupt on Done
-#define I2C_C_ST (1 << 7) // Start transfer
-#define I2C_C_CLEAR_FIFO_NONE (0b00 << 4)
-#define I2C_C_CLEAR_FIFO_ONE_SHOT (0b01 << 4)
-#define I2C_C_CLEAR_FIFO_ONE_SHOT2 (0b10 << 4)
-#define I2C_C_WRITE_PACKET (0 << 0)
-#define I2C_C_READ_PACKET (1 << 0)
-
-#define I2C_S_CLKT (1 << 9) // Clock stretch timeout
-#define I2C_S_ERR (1 << 8) // ERR Ack error
-#define I2C_S_RXF (1 << 7) // RX FIFO full
-#define I2C_S_TXE (1 << 6) // TX FIFO empty
-#define I2C_S_RXD (1 << 5) // RX contains data
-#define I2C_S_TXD (1 << 4) // TX contains data
-#define I2C_S_RXR (1 << 3) // RX needs reading
-#define I2C_S_TXW (1 << 2) // TX needs writing
-#define I2C_S_DONE (1 << 1) // Transfer done
-#define I2C_S_TA (1 << 0) // Transfer active
-
-typedef struct tI2cRegs {
-    ULONG C;
-    ULONG S;
-    ULONG DLEN;
-    ULONG A;
-    ULONG FIFO;
-    ULONG DIV;
-    ULONG DEL;
-    ULONG CLKT;
-} tI2cRegs;
-
 #define BCM2708_PERI_BASE 0xF2000000
 
 #define BCM_GPIO ((volatile tGpioRegs*)(BCM2708_PERI_BASE + 0x200000));
 #define BCM_I2C0 (volatile tI2cRegs*)(BCM2708_PERI_BASE + 0x205000);
 
-#define CORE_CLOCK (150*1000*1000)
-#define I2C_SPEED 100000
-
-
-#define RESULT(isSuccess, ubIoError, ubAllocError) ((ubAllocError << 16) | (ubIoError << 8) | (isSuccess))
+#define CORE_CLOCK (150*1000*1000)   // Fallback if the firmware does not report core clock
 
 
-// Allocation Errors
-// (as returned by AllocI2C, BringBackI2C, or found in the middle high
-// byte of the error codes from V39's SendI2C/ReceiveI2C)
-enum {
-    I2C_OK=0, // Hardware allocated successfully
-    I2C_PORT_BUSY, // \_Allocation is actually done in two steps:
-    I2C_BITS_BUSY, // / port & bits, and each step may fail
-    I2C_NO_MISC_RESOURCE, // Shouldn't occur, something's very wrong
-    I2C_ERROR_PORT, // Failed to create a message port
-    I2C_ACTIVE, // Some other I2C client has pushed us out
-    I2C_NO_TIMER // Failed to open the timer.device
+#define TC358743_I2C_ADDR 0x1e
+#define CHIPID              0x0000
+#define MASK_CHIPID         0xff00
+#define CONFCTL             0x0004
+#define PLLCTL0             0x0020
+#define PLLCTL1             0x0022
+#define CLW_CNTRL           0x0140
+#define STARTCNTRL          0x0204
+#define LINEINITCNT         0x0210
+#define LPTXTIMECNT         0x0214
+#define TCLK_HEADERCNT      0x0218
+#define TCLK_TRAILCNT       0x021C
+#define THS_HEADERCNT       0x0220
+#define TWAKEUP             0x0224
+#define TCLK_POSTCNT        0x0228
+#define THS_TRAILCNT        0x022C
+#define HSTXVREGEN          0x0234
+#define CSI_START           0x0518
+#define CSI_CONFW           0x0500
+#define VOUT_SET2           0x8573
+#define VOUT_SET3           0x8574
+#define VI_REP              0x8576
+#define MASK_YCBCRFMT_422_8 0x00C0          // CONFCTL: YCbCr 4:2:2 8-bit output
+#define MASK_SEL422         0xC0            // VOUT_SET2: 4:2:2 output, 3-tap chroma filter
+#define MASK_COLOR_601_LIM  0x60            // VI_REP: BT.601 limited range YCbCr
+#define CSI_CONFW_MODE      0xA3008080      // Set bits of CSI_CONTROL: CSI mode, HS transmit, ...
+#define CSI_CONFW_NOL(n)    (((n) - 1) << 1)  // ... and number of lanes
+
+#define C790_RESET_DELAY    20000   // Reset pulse of the chip, us
+#define C790_PHY_DELAY      200000  // Settle time after HDMI PHY reset, us
+#define C790_BURST          128     // Maximal number of data bytes in a single write transaction
+
+/*
+    Registers of the chip are written from a table. Entries with zero size are delays. The chip
+    auto-increments register address within a transaction, so runs of entries which target
+    consecutive addresses are sent as a single burst. Multi-byte registers are little endian.
+*/
+struct C790Reg {
+    UWORD   reg;
+    UWORD   size;
+    ULONG   value;
 };
 
-// I/O Errors
-// (as found in the middle low byte of the error codes from V39's
-// SendI2C/ReceiveI2C)
-enum {
-    // I2C_OK=0, // Last send/receive was OK
-    I2C_REJECT=1, // Data not acknowledged (i.e. unwanted) */
-    I2C_NO_REPLY, // Chip address apparently invalid */
-    SDA_TRASHED, // SDA line randomly trashed. Timing problem? */
-    SDA_LO, // SDA always LO \_wrong interface attached, */
-    SDA_HI, // SDA always HI / or none at all? */
-    SCL_TIMEOUT, // \_Might make sense for interfaces that can */
-    SCL_HI,      // / read the clock line, but currently none can. */
-    I2C_HARDW_BUSY // Hardware allocation failed
-};
+#define REG8(r, v)      { r, 1, v }
+#define REG16(r, v)     { r, 2, v }
+#define REG32(r, v)     { r, 4, v }
+#define DELAY(us)       { 0, 0, us }
 
-ULONG SendI2C(
-    UBYTE ubAddress,
-    UWORD uwDataSize,
-    UBYTE pData[],
-    volatile tI2cRegs *pI2c
-)
+static void write_table(const struct C790Reg *table, ULONG count, volatile tI2cRegs *pI2c)
 {
-    // bcm expects read/write bit to be omitted from address
-    ubAddress >>= 1;
+    UBYTE buf[2 + C790_BURST];
+    ULONG i = 0;
+
+    while (i < count)
+    {
+        if (table[i].size == 0)
+        {
+            timer_delay(table[i].value);
+            i++;
+            continue;
+        }
 
-    if(rd32le(&pI2c->S) & I2C_S_TA) {
-        return RESULT(0, I2C_HARDW_BUSY, 0);
-    }
+        UWORD reg = table[i].reg;
+        UWORD len = 0;
 
-    UBYTE isSuccess = 1, ubIoError = I2C_OK, ubAllocError = I2C_OK;
-    wr32le(&pI2c->A, ubAddress);
-    wr32le(&pI2c->C, I2C_C_CLEAR_FIFO_ONE_SHOT);
-    wr32le(&pI2c->S, I2C_S_CLKT | I2C_S_ERR | I2C_S_DONE);
-    wr32le(&pI2c->DLEN, uwDataSize);
-    wr32le(&pI2c->C, I2C_C_I2CEN | I2C_C_ST | I2C_C_WRITE_PACKET);
-
-    UWORD uwBytesCopied = 0;
-    while(!(rd32le(&pI2c->S) & I2C_S_DONE)) {
-        while(uwDataSize && (rd32le(&pI2c->S) & I2C_S_TXW)) {
-            wr32le(&pI2c->FIFO, *(pData++));
-            uwBytesCopied++;
-            --uwDataSize;
+        buf[0] = reg >> 8;
+        buf[1] = reg & 0xff;
+
+        while (i < count && table[i].size != 0 && table[i].reg == reg + len &&
+               len + table[i].size <= C790_BURST)
+        {
+            for (int b = 0; b < table[i].size; b++)
+                buf[2 + len + b] = table[i].value >> (8 * b);
+
+            len += table[i].size;
+            i++;
         }
+
+        LONG res = SendI2C(TC358743_I2C_ADDR, 2 + len, buf, pI2c);
+        if ((res & 0xff) == 0)
+            bug("[unicam] I2C write error: reg 0x%04lx, code %ld\n", reg, res);
     }
+}
 
-    ULONG ulStatus = rd32le(&pI2c->S);
-    wr32le(&pI2c->S, I2C_S_DONE);
+static void add_reg(struct C790Reg *entry, UWORD reg, UWORD size, ULONG value)
+{
+    entry->reg = reg;
+    entry->size = size;
+    entry->value = value;
+}
 
-    if((ulStatus & (I2C_S_ERR | I2C_S_CLKT)) || uwDataSize) {
-        isSuccess = 0;
-        ubIoError = I2C_REJECT;
-    }
-    
-    return RESULT(isSuccess, ubIoError, ubAllocError);
+/* Output data format bits of CONFCTL for the CSI-2 data type */
+static UWORD confctl_format(UBYTE datatype)
+{
+    return datatype == CSI_DT_YUV422_8 ? MASK_YCBCRFMT_422_8 : 0;
 }
 
-#define TC358743_I2C_ADDR 0x1e
+/*
+    CSI transmitter setup depends on lane count and on the link rate computed for the mode, so the
+    sequence is assembled at runtime. Entries are filled one by one, no table is copied. Lane control
+    registers CLW_CNTRL, D0W_CNTRL .. D3W_CNTRL follow each other, writing 1 disables a lane. Timing
+    registers LINEINITCNT .. THS_TRAILCNT follow each other too, so each group goes out as a burst.
+*/
+static void setup_csi(UBYTE lanes, UBYTE datatype, const struct CSITiming *timing, volatile tI2cRegs *pI2c)
+{
+    struct C790Reg regs[21];
+    int n = 0;
+
+    add_reg(&regs[n++], PLLCTL0, 2, timing->ct_PLLCtl0);
+    add_reg(&regs[n++], PLLCTL1, 2, timing->ct_PLLCtl1);
+    add_reg(&regs[n++], CONFCTL, 2, 0x0E24 | confctl_format(datatype));
+
+    for (int i=0; i < 5; i++)
+        add_reg(&regs[n++], CLW_CNTRL + 4 * i, 4, i > lanes ? 1 : 0);
+
+    add_reg(&regs[n++], LINEINITCNT, 4, timing->ct_LineInit);
+    add_reg(&regs[n++], LPTXTIMECNT, 4, timing->ct_LPTxTime);
+    add_reg(&regs[n++], TCLK_HEADERCNT, 4, timing->ct_TClkHeader);
+    add_reg(&regs[n++], TCLK_TRAILCNT, 4, timing->ct_TClkTrail);
+    add_reg(&regs[n++], THS_HEADERCNT, 4, timing->ct_THSHeader);
+    add_reg(&regs[n++], TWAKEUP, 4, timing->ct_TWakeup);
+    add_reg(&regs[n++], TCLK_POSTCNT, 4, timing->ct_TClkPost);
+    add_reg(&regs[n++], THS_TRAILCNT, 4, timing->ct_THSTrail);
+    add_reg(&regs[n++], HSTXVREGEN, 4, 0x0000001F);
+    add_reg(&regs[n++], STARTCNTRL, 4, 1);
+    add_reg(&regs[n++], CSI_START, 4, 1);
+    add_reg(&regs[n++], CSI_CONFW, 4, CSI_CONFW_MODE | CSI_CONFW_NOL(lanes));
+
+    write_table(regs, n, pI2c);
+}
 
-int write_reg(int reg, const uint8_t *data, int nbytes, volatile tI2cRegs *pI2c) {
-    UBYTE i2cbuf[6];
+int read_reg(int reg, uint8_t *data, int nbytes, volatile tI2cRegs *pI2c) {
+    UBYTE i2cbuf[2];
     i2cbuf[0] = (reg >> 8) & 0xFF;
     i2cbuf[1] = reg & 0xFF;
-    switch(nbytes) {
-        case 4:
-            i2cbuf[4] = data[2];
-            i2cbuf[5] = data[3];
-        case 2: // Fallthrough
-            i2cbuf[3] = data[1];
-        case 1: // Fallthrough
-            i2cbuf[2] = data[0];
-            break;
-        default:
-            break;
-    }
-    LONG res = SendI2C(TC358743_I2C_ADDR, 2 + nbytes, i2cbuf, pI2c);
+    LONG res = TransferI2C(TC358743_I2C_ADDR, 2, i2cbuf, nbytes, data, pI2c);
     if( (res & 0xff)==0 ) {
-        bug("[unicam] I2C write error: reg 0x%04lx, code %ld\n", reg, res);
+        bug("[unicam] I2C read error: reg 0x%04lx, code %ld\n", reg, res);
         return 0;
     }
-    return 0;
+    return 1;
 }
 
-int write_reg8(int reg, uint8_t val, volatile tI2cRegs *pI2c) {
-    return write_reg(reg, &val, 1, pI2c);
+void _memcpy(uint8_t *to, const uint8_t *from, int n) {
+    while(n--) *to++ = *from++;
 }
 
-void u16_to_bytes(uint16_t val, uint8_t *buf, int big_endian) {
-    if (big_endian) {
-        buf[0] = (val >> 8) & 0xFF;
-        buf[1] = val & 0xFF;
-    } else {
-        buf[0] = val & 0xFF;
-        buf[1] = (val >> 8) & 0xFF;
+/* EDID of a profile together with the capture format it is meant for */
+struct EdidProfile {
+    const char *    ep_Name;
+    UWORD           ep_Width;
+    UWORD           ep_Height;
+    UBYTE           ep_DataType;
+    UBYTE           ep_BPP;
+    UBYTE           ep_EDID[256];
+};
+
+#include "edid.h"
+
+/*
+    Select EDID profile by name. Capture size, data type and bpp are taken from the profile, displayed
+    window is clipped to it. Returns FALSE if there is no such profile.
+*/
+BOOL c790_select_edid(struct UnicamBase * UnicamBase, const char *name)
+{
+    for (int i=0; i < EDID_COUNT; i++)
+    {
+        const struct EdidProfile *profile = &edid_profiles[i];
+
+        if (_strcmp(name, profile->ep_Name) != 0)
+            continue;
+
+        UnicamBase->u_EDID = profile->ep_EDID;
+        UnicamBase->u_FullSize.width = profile->ep_Width;
+        UnicamBase->u_FullSize.height = profile->ep_Height;
+        UnicamBase->u_Mode = profile->ep_DataType;
+        UnicamBase->u_BPP = profile->ep_BPP;
+
+        if (UnicamBase->u_Size.width == 0 || UnicamBase->u_Size.width > profile->ep_Width)
+            UnicamBase->u_Size.width = profile->ep_Width;
+        if (UnicamBase->u_Size.height == 0 || UnicamBase->u_Size.height > profile->ep_Height)
+            UnicamBase->u_Size.height = profile->ep_Height;
+        if (UnicamBase->u_Offset.x + UnicamBase->u_Size.width > profile->ep_Width)
+            UnicamBase->u_Offset.x = profile->ep_Width - UnicamBase->u_Size.width;
+        if (UnicamBase->u_Offset.y + UnicamBase->u_Size.height > profile->ep_Height)
+            UnicamBase->u_Offset.y = profile->ep_Height - UnicamBase->u_Size.height;
+
+        return TRUE;
     }
+
+    return FALSE;
 }
 
-void u32_to_bytes(uint32_t val, uint8_t *buf, int big_endian) {
-    if (big_endian) {
-        buf[0] = (val >> 24) & 0xFF;
-        buf[1] = (val >> 16) & 0xFF;
-        buf[2] = (val >> 8) & 0xFF;
-        buf[3] = val & 0xFF;
-    } else {
-        buf[0] = val & 0xFF;
-        buf[1] = (val >> 8) & 0xFF;
-        buf[2] = (val >> 16) & 0xFF;
-        buf[3] = (val >> 24) & 0xFF;
+
+// ---- EDID Programming ----
+void program_edid(const uint8_t edid[256], volatile tI2cRegs *pI2c) {
+    for (int i = 0; i < 256; i += C790_BURST) {
+        uint8_t buf[2 + C790_BURST];
+        buf[0] = ((0x8C00 + i) >> 8) & 0xFF;
+        buf[1] = (0x8C00 + i) & 0xFF;
+        _memcpy(&buf[2], &edid[i], C790_BURST);
+        LONG res = SendI2C(TC358743_I2C_ADDR, 2 + C790_BURST, buf, pI2c);
+        if( (res & 0xff)==0 ){
+            bug("[unicam] I2C EDID write error at 0x%04lx, code %ld\n", 0x8C00 + i, res);
+            return;
+        }
     }
 }
 
-int write_reg16(int reg, uint16_t val, int big_endian, volatile tI2cRegs *pI2c) {
-    uint8_t data[2];
-    u16_to_bytes(val, data, big_endian);
-    return write_reg(reg, data, 2, pI2c);
-}
+/* Chip reset and clocks */
+static const struct C790Reg c790_init_csi[] = {
+    REG16(0x0004, 0x0000),
+    REG16(0x0002, 0x0F00),
+    DELAY(C790_RESET_DELAY),
+    REG16(0x0002, 0x0000),
+    REG16(0x0006, 0x0080),      // sub 720 = 0x80 , >720p =0x08
+    REG16(0x0008, 0x005F),
+    REG16(0x0014, 0xFFFF),
+    REG16(0x0016, 0x051F),
+};
 
-int write_reg32(int reg, uint32_t val, int big_endian, volatile tI2cRegs *pI2c) {
-    uint8_t data[4];
-    u32_to_bytes(val, data, big_endian);
-    return write_reg(reg, data, 4, pI2c);
-}
+/* HDMI receiver setup, up to EDID */
+static const struct C790Reg c790_init_rx[] = {
+    REG8(0x8502, 0x01),
+    REG8(0x8512, 0xFE),
+    REG8(0x8513, 0xDF),
+    REG8(0x8515, 0xFD),
+
+    REG8(0x8531, 0x01),
+    REG16(0x8540, 0x0A8C),
+    REG32(0x8630, 0x00041EB0),
+    REG8(0x8670, 0x01),
+    REG8(0x8532, 0x80),
+    REG8(0x8536, 0x40),
+    REG8(0x853F, 0x0A),
+    REG8(0x8543, 0x32),
+    REG8(0x8544, 0x10),
+    REG8(0x8545, 0x31),
+    REG8(0x8546, 0x2D),
+    REG8(0x85C7, 0x01),
+    REG8(0x85CB, 0x01),
+};
 
-void _memcpy(uint8_t *to, const uint8_t *from, int n) {
-    while(n--) *to++ = *from++;
-}
+/* HDMI PHY reset */
+static const struct C790Reg c790_init_hdmi[] = {
+    REG8(0x8544, 0x01),
+    REG8(0x8544, 0x00),
+    DELAY(C790_PHY_DELAY),
+    REG8(0x8544, 0x10),
+
+    REG8(0x85D1, 0x01),
+    REG8(0x8560, 0x24),
+    REG8(0x8563, 0x11),
+    REG8(0x8564, 0x0F),
+};
 
-static const uint8_t EDID_576p[256]  = {
-  0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x05, 0xd7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  0xff, 0x22, 0x01, 0x03, 0x80, 0x32, 0x1f, 0x78, 0x07, 0xee, 0x95, 0xa3, 0x54, 0x4c, 0x99, 0x26,
-  0x0f, 0x50, 0x54, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
-  0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x8c, 0x0a, 0xd0, 0x90, 0x20, 0x40, 0x31, 0x20, 0x0c, 0x40,
-  0x55, 0x00, 0xd8, 0xac, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfd, 0x00, 0x17, 0xf0, 0x0f,
-  0xff, 0x0b, 0x00, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00, 0xfc, 0x00, 0x45,
-  0x44, 0x54, 0x56, 0x20, 0x35, 0x37, 0x36, 0x70, 0x0a, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xee,
-  0x02, 0x03, 0x16, 0x00, 0x41, 0xa5, 0x67, 0x03, 0x0c, 0x00, 0x00, 0x00, 0x11, 0x16, 0x67, 0xd8,
-  0x5d, 0xc4, 0x01, 0x16, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6b
+/* Audio and info frame setup following the video format */
+static const struct C790Reg c790_init_out[] = {
+    REG8(0x8600, 0x00),
+    REG8(0x8602, 0xF3),
+    REG8(0x8603, 0x02),
+    REG8(0x8604, 0x0C),
+    REG8(0x8606, 0x05),
+    REG8(0x8607, 0x00),
+    REG8(0x8620, 0x00),
+    REG8(0x8640, 0x01),
+    REG8(0x8641, 0x65),
+    REG8(0x8642, 0x07),
+    REG8(0x8652, 0x02),
+    REG8(0x8665, 0x10),
+
+    REG8(0x8709, 0xFF),
+    REG8(0x870B, 0x2C),
+    REG8(0x870C, 0x53),
+    REG8(0x870D, 0x01),
+    REG8(0x870E, 0x30),
+    REG8(0x9007, 0x10),
+    REG8(0x854A, 0x01),
+
+    DELAY(C790_PHY_DELAY),
 };
 
+/*
+    Video output format. RGB888 is passed through, for YUV422 the bridge converts the incoming RGB with
+    its own colour space converter and subsamples the chroma, so the source is not asked for YCbCr.
+*/
+static void setup_format(UBYTE datatype, volatile tI2cRegs *pI2c)
+{
+    struct C790Reg regs[3];
+    BOOL yuv = datatype == CSI_DT_YUV422_8;
+
+    add_reg(&regs[0], VOUT_SET2, 1, yuv ? MASK_SEL422 : 0);
+    add_reg(&regs[1], VOUT_SET3, 1, 0);
+    add_reg(&regs[2], VI_REP, 1, yuv ? MASK_COLOR_601_LIM : 0);
 
-void delay(ULONG us)
+    write_table(regs, 3, pI2c);
+}
+
+/* Final TX buffer enable */
+static void enable_output(UBYTE datatype, volatile tI2cRegs *pI2c)
 {
-    ULONG timer = LE32(*(volatile ULONG*)0xf2003004);
-    ULONG end = timer + us;
+    struct C790Reg reg;
 
-    if (end < timer) {
-        while (end < LE32(*(volatile ULONG*)0xf2003004)) asm volatile("nop");
-    }
-    while (end > LE32(*(volatile ULONG*)0xf2003004)) asm volatile("nop");
+    add_reg(&reg, CONFCTL, 2, 0x0E27 | confctl_format(datatype));
+    write_table(&reg, 1, pI2c);
 }
 
-// ---- EDID Programming ----
-void program_edid(const uint8_t edid[256], int big_endian, volatile tI2cRegs *pI2c) {
-    for (int i = 0; i < 256; i += 16) {
-        uint8_t buf[18];
-        //if (big_endian) {
-            buf[0] = ((0x8C00 + i) >> 8) & 0xFF;
-            buf[1] = (0x8C00 + i) & 0xFF;
-        //} else {
-        //    buf[0] = (0x8C00 + i) & 0xFF;
-        //    buf[1] = ((0x8C00 + i) >> 8) & 0xFF;
-        //}
-        _memcpy(&buf[2], &edid[i], 16);
-        LONG res = SendI2C(TC358743_I2C_ADDR, 18, buf, pI2c);
-        if( (res & 0xff)==0 ){
-            bug("[unicam] I2C EDID write error at 0x%04lx, code %ld\n", 0x8C00 + i, res);
-            return;
-        }
+/* Link timing for given pixel clock (10kHz units) and line length, the rate is kept for the receiver */
+static void compute_link(struct UnicamBase * UnicamBase, struct CSITiming *timing, ULONG pixclk, ULONG hactive,
+    ULONG htotal)
+{
+    if (!csi_compute_timing(timing, pixclk, hactive, htotal, UnicamBase->u_BPP ? UnicamBase->u_BPP : 24,
+            UnicamBase->u_Lanes))
+    {
+        bug("[unicam] Mode does not fit into %ld CSI-2 lanes\n", UnicamBase->u_Lanes);
     }
+
+    UnicamBase->u_LinkRate = timing->ct_Rate;
+    bug("[unicam] CSI-2 link at %ld Mbps per lane\n", timing->ct_Rate / 1000);
 }
 
 void init_c790_ic(struct UnicamBase * UnicamBase)
 {
     volatile tI2cRegs *pI2c = BCM_I2C0;
     volatile tGpioRegs *pGpio = BCM_GPIO;
-    int big_endian = 0;
 
     UBYTE ubPinSda = 44;
     UBYTE ubPinScl = 45;
@@ -361,98 +451,117 @@ void init_c790_ic(struct UnicamBase * UnicamBase)
     gpioSetPull(pGpio, ubPinScl, GPIO_PULL_OFF);
 
 
-    //  --- CSI and Chip
-    write_reg16(0x0004, 0x0000, big_endian, pI2c);
-    write_reg16(0x0002, 0x0F00, big_endian, pI2c);
-    delay(1 * 20000);
-    write_reg16(0x0002, 0x0000, big_endian, pI2c);
-    write_reg16(0x0006, 0x0080, big_endian, pI2c); //sub 720 = 0x80 , >720p =0x08
-    write_reg16(0x0008, 0x005F, big_endian, pI2c);
-    write_reg16(0x0014, 0xFFFF, big_endian, pI2c);
-    write_reg16(0x0016, 0x051F, big_endian, pI2c);
-    write_reg16(0x0020, 0x8111, big_endian, pI2c);
-    write_reg16(0x0022, 0x0213, big_endian, pI2c);
-    write_reg16(0x0004, 0x0E24, big_endian, pI2c);  // datatype
-
-    write_reg32(0x0140, 0x00000000, big_endian, pI2c);
-    write_reg32(0x0144, 0x00000000, big_endian, pI2c);
-    write_reg32(0x0148, 0x00000001, big_endian, pI2c); // one Lane = 0x1 , two lane = 0x0
-    write_reg32(0x014C, 0x00000001, big_endian, pI2c);
-    write_reg32(0x0150, 0x00000001, big_endian, pI2c);
-
-    write_reg32(0x0210, 0x00002988, big_endian, pI2c);
-    write_reg32(0x0214, 0x00000005, big_endian, pI2c);
-    write_reg32(0x0218, 0x00001D04, big_endian, pI2c);
-    write_reg32(0x021C, 0x00000002, big_endian, pI2c);
-    write_reg32(0x0220, 0x00000504, big_endian, pI2c);
-    write_reg32(0x0224, 0x00004600, big_endian, pI2c);
-    write_reg32(0x0228, 0x0000000A, big_endian, pI2c);
-    write_reg32(0x022C, 0x00000004, big_endian, pI2c);
-    write_reg32(0x0234, 0x0000001F, big_endian, pI2c);
-    write_reg32(0x0204, 0x00000001, big_endian, pI2c);
-
-    write_reg32(0x0518, 0x00000001, big_endian, pI2c);
-    write_reg32(0x0500, 0xA3008080, big_endian, pI2c);
-
-    write_reg8(0x8502, 0x01, pI2c);
-    write_reg8(0x8512, 0xFE, pI2c);
-    write_reg8(0x8513, 0xDF, pI2c);
-    write_reg8(0x8515, 0xFD, pI2c);
-
-    write_reg8(0x8531, 0x01, pI2c);
-    write_reg16(0x8540, 0x0A8C, big_endian, pI2c);
-    write_reg32(0x8630, 0x00041EB0, big_endian, pI2c);
-    write_reg8(0x8670, 0x01, pI2c);
-    write_reg8(0x8532, 0x80, pI2c);
-    write_reg8(0x8536, 0x40, pI2c);
-    write_reg8(0x853F, 0x0A, pI2c);
-    write_reg8(0x8543, 0x32, pI2c);
-    write_reg8(0x8544, 0x10, pI2c);
-    write_reg8(0x8545, 0x31, pI2c);
-    write_reg8(0x8546, 0x2D, pI2c);
-    write_reg8(0x85C7, 0x01, pI2c);
-    write_reg8(0x85CB, 0x01, pI2c);
-    
-    // --- EDID programming ---
-    program_edid(EDID_576p, big_endian, pI2c);
-
-    // --- HDMI RX ----
-    write_reg8(0x8544, 0x01, pI2c);
-    write_reg8(0x8544, 0x00, pI2c);
-    delay(10 * 20000);
-    write_reg8(0x8544, 0x10, pI2c);
-
-    write_reg8(0x85D1, 0x01, pI2c);
-    write_reg8(0x8560, 0x24, pI2c);
-    write_reg8(0x8563, 0x11, pI2c);
-    write_reg8(0x8564, 0x0F, pI2c);
-
-    write_reg8(0x8574, 0x00, pI2c);  //RGB
-    write_reg8(0x8573, 0x00, pI2c);  //RGB
-    write_reg8(0x8576, 0x00, pI2c);  //RGB
-
-    write_reg8(0x8600, 0x00, pI2c);
-    write_reg8(0x8602, 0xF3, pI2c);
-    write_reg8(0x8603, 0x02, pI2c);
-    write_reg8(0x8604, 0x0C, pI2c);
-    write_reg8(0x8606, 0x05, pI2c);
-    write_reg8(0x8607, 0x00, pI2c);
-    write_reg8(0x8620, 0x00, pI2c);
-    write_reg8(0x8640, 0x01, pI2c);
-    write_reg8(0x8641, 0x65, pI2c);
-    write_reg8(0x8642, 0x07, pI2c);
-    write_reg8(0x8652, 0x02, pI2c);
-    write_reg8(0x8665, 0x10, pI2c);
-
-    write_reg8(0x8709, 0xFF, pI2c);
-    write_reg8(0x870B, 0x2C, pI2c);
-    write_reg8(0x870C, 0x53, pI2c);
-    write_reg8(0x870D, 0x01, pI2c);
-    write_reg8(0x870E, 0x30, pI2c);
-    write_reg8(0x9007, 0x10, pI2c);
-    write_reg8(0x854A, 0x01, pI2c);
-
-    delay(10 * 20000);
-    // --- Final TX buffer enable ---
-    write_reg16(0x0004, 0x0E27, big_endian, pI2c);
+    ULONG core_clock = get_clock_rate(UnicamBase, CLOCK_CORE);
+    i2c_set_speed(pI2c, core_clock ? core_clock : CORE_CLOCK);
+
+    /* Do not spend the whole init sequence on timeouts if the board is not there */
+    UBYTE id[2];
+    if (!read_reg(CHIPID, id, 2, pI2c) || (id[1] << 8) & MASK_CHIPID)
+    {
+        bug("[unicam] TC358743 not found\n");
+        return;
+    }
+
+    /* Link rate follows the preferred timing of the EDID offered to the source */
+    const UBYTE *edid = UnicamBase->u_EDID ? UnicamBase->u_EDID : edid_profiles[EDID_DEFAULT].ep_EDID;
+    ULONG pixclk = edid[54] | (edid[55] << 8);
+    ULONG hactive = edid[56] | ((edid[58] & 0xf0) << 4);
+    ULONG hblank = edid[57] | ((edid[58] & 0x0f) << 8);
+    struct CSITiming timing;
+
+    compute_link(UnicamBase, &timing, pixclk, hactive, hactive + hblank);
+
+    write_table(c790_init_csi, sizeof(c790_init_csi) / sizeof(c790_init_csi[0]), pI2c);
+    setup_csi(UnicamBase->u_Lanes, UnicamBase->u_Mode, &timing, pI2c);
+    write_table(c790_init_rx, sizeof(c790_init_rx) / sizeof(c790_init_rx[0]), pI2c);
+    program_edid(edid, pI2c);
+    write_table(c790_init_hdmi, sizeof(c790_init_hdmi) / sizeof(c790_init_hdmi[0]), pI2c);
+    setup_format(UnicamBase->u_Mode, pI2c);
+    write_table(c790_init_out, sizeof(c790_init_out) / sizeof(c790_init_out[0]), pI2c);
+    enable_output(UnicamBase->u_Mode, pI2c);
+}
+
+#define SYS_STATUS          0x8520
+#define MASK_S_SYNC         0x80
+#define VI_STATUS1          0x8522
+#define MASK_S_V_INTERLACE  0x04
+#define DE_WIDTH_H_LO       0x8582
+#define DE_WIDTH_V_LO       0x8588
+#define H_SIZE_LO           0x858E
+#define FV_CNT_LO           0x85A1
+#define SYSCTL              0x0002
+#define MASK_CTXRST         0x0200
+
+/* Active size of the incoming HDMI signal as (width << 16) | height, 0 if there is no sync */
+ULONG c790_get_mode(void)
+{
+    volatile tI2cRegs *pI2c = BCM_I2C0;
+    UBYTE status[3];
+    UBYTE h[2];
+    UBYTE v[2];
+
+    if (!read_reg(SYS_STATUS, status, 3, pI2c) || !(status[0] & MASK_S_SYNC))
+        return 0;
+
+    if (!read_reg(DE_WIDTH_H_LO, h, 2, pI2c) || !read_reg(DE_WIDTH_V_LO, v, 2, pI2c))
+        return 0;
+
+    ULONG width = h[0] | ((h[1] & 0x1f) << 8);
+    ULONG height = v[0] | ((v[1] & 0x1f) << 8);
+
+    /* Interlaced signals report the size of a single field */
+    if (status[2] & MASK_S_V_INTERLACE)
+        height *= 2;
+
+    return (width << 16) | height;
+}
+
+/* CSI transmitter reset, the HDMI receiver keeps its lock */
+static const struct C790Reg c790_reset_tx[] = {
+    REG16(CONFCTL, 0x0000),
+    REG16(SYSCTL, MASK_CTXRST),
+    REG16(SYSCTL, 0x0000),
+};
+
+/*
+    Set the CSI-2 link up again for the mode the source sends now, with capture stopped. The pixel
+    clock is not reported by the bridge, it follows from total frame size and frame interval (in
+    0.1ms units, V_SIZE counts half lines) the way the Linux driver derives it. Returns FALSE and leaves
+    the link alone if the timing cannot be read.
+*/
+BOOL c790_update_timing(struct UnicamBase * UnicamBase)
+{
+    volatile tI2cRegs *pI2c = BCM_I2C0;
+    UBYTE status[3];
+    UBYTE h[2];
+    UBYTE size[4];
+    UBYTE fv[2];
+
+    if (!read_reg(SYS_STATUS, status, 3, pI2c) || !(status[0] & MASK_S_SYNC))
+        return FALSE;
+
+    if (!read_reg(DE_WIDTH_H_LO, h, 2, pI2c) || !read_reg(H_SIZE_LO, size, 4, pI2c) || !read_reg(FV_CNT_LO, fv, 2, pI2c))
+        return FALSE;
+
+    ULONG hactive = h[0] | ((h[1] & 0x1f) << 8);
+    ULONG htotal = size[0] | ((size[1] & 0x1f) << 8);
+    ULONG vtotal = (size[2] | ((size[3] & 0x3f) << 8)) / 2;
+    ULONG interval = fv[0] | ((fv[1] & 0x03) << 8);
+
+    if (hactive == 0 || htotal == 0 || vtotal == 0 || interval == 0)
+        return FALSE;
+
+    ULONG pixclk = (htotal * vtotal + interval - 1) / interval;
+    if (status[2] & MASK_S_V_INTERLACE)
+        pixclk = (pixclk + 1) / 2;
+
+    struct CSITiming timing;
+
+    compute_link(UnicamBase, &timing, pixclk, hactive, htotal);
+
+    write_table(c790_reset_tx, sizeof(c790_reset_tx) / sizeof(c790_reset_tx[0]), pI2c);
+    setup_csi(UnicamBase->u_Lanes, UnicamBase->u_Mode, &timing, pI2c);
+    enable_output(UnicamBase->u_Mode, pI2c);
+
+    return TRUE;
 }
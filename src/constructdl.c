@@ -10,289 +10,167 @@
 #include <exec/types.h>
 #include <common/compiler.h>
 
+#include <proto/exec.h>
+
 #include "unicam.h"
 #include "videocore.h"
-#include "smoothing.h"
+
+/*
+    Part of the frame written to memory. With the capture window enabled it is the crop rectangle,
+    YUV windows start and end on pixel pairs. Returns FALSE if the whole frame is captured.
+*/
+BOOL unicam_get_window(struct UnicamBase * UnicamBase, struct Point *offset, struct Size *size)
+{
+    ULONG full_width = UnicamBase->u_CaptureSize.width ? UnicamBase->u_CaptureSize.width : UnicamBase->u_FullSize.width;
+    ULONG full_height = UnicamBase->u_CaptureSize.height ? UnicamBase->u_CaptureSize.height : UnicamBase->u_FullSize.height;
+    ULONG x = UnicamBase->u_Offset.x;
+    ULONG width = UnicamBase->u_Size.width;
+
+    offset->x = 0;
+    offset->y = 0;
+    size->width = full_width;
+    size->height = full_height;
+
+    if (!UnicamBase->u_Window || width == 0 || UnicamBase->u_Size.height == 0 ||
+        x + width > full_width || UnicamBase->u_Offset.y + UnicamBase->u_Size.height > full_height)
+    {
+        return FALSE;
+    }
+
+    if (UNICAM_IS_YUV(UnicamBase))
+    {
+        x &= ~1UL;
+        width = (width + 1) & ~1UL;
+        if (x + width > full_width)
+            width -= 2;
+    }
+
+    offset->x = x;
+    offset->y = UnicamBase->u_Offset.y;
+    size->width = width;
+    size->height = UnicamBase->u_Size.height;
+
+    return TRUE;
+}
+
+/* Bytes per line of the captured data, narrower than the frame if Unicam writes a window only */
+ULONG unicam_stride(struct UnicamBase * UnicamBase)
+{
+    struct Point offset;
+    struct Size size;
+
+    if (!unicam_get_window(UnicamBase, &offset, &size))
+        size.width = UnicamBase->u_FullSize.width;
+
+    return unicam_line_stride(UnicamBase, size.width, UnicamBase->u_BPP);
+}
+
+/* Address of the first displayed pixel within the frame buffer shown on screen */
+ULONG unicam_display_address(struct UnicamBase * UnicamBase)
+{
+    ULONG startAddress = (ULONG)UnicamBase->u_ReceiveBuffer;
+    ULONG x = UnicamBase->u_Offset.x;
+    ULONG y = UnicamBase->u_Offset.y;
+    struct Point offset;
+    struct Size size;
+
+    /* Captured window starts at the crop offset already */
+    if (unicam_get_window(UnicamBase, &offset, &size))
+    {
+        x -= offset.x;
+        y -= offset.y;
+    }
+
+    /* YUV 4:2:2 shares chroma between pixel pairs, the window cannot start in the middle of one */
+    if (UNICAM_IS_YUV(UnicamBase))
+        x &= ~1UL;
+
+    if (UnicamBase->u_ActiveBuffers != 0)
+        startAddress = (ULONG)UnicamBase->u_Buffers[UnicamBase->u_DisplayBuffer];
+
+    startAddress += x * (UnicamBase->u_BPP / 8);
+    startAddress += y * unicam_stride(UnicamBase);
+
+    return startAddress;
+}
+
+/* Rewrite the address word of the registered display list, if there is one */
+void unicam_update_address(struct UnicamBase * UnicamBase)
+{
+    UnicamBase->u_OffsetPending = FALSE;
+
+    if (UnicamBase->u_DLAddressWord) {
+        *UnicamBase->u_DLAddressWord = LE32(0xc0000000 | unicam_display_address(UnicamBase));
+        MMIO_WRITE(UnicamBase, 1);
+    }
+}
 
 ULONG L_UnicamConstructDL(REGARG(ULONG * dlist, "a0"), REGARG(ULONG offset, "d0"), REGARG(struct UnicamBase * UnicamBase, "a6"))
 {
-    int unity = 0;
-    ULONG scale_x = 0;
-    ULONG scale_y = 0;
-    ULONG scale = 0;
-    ULONG recip_x = 0;
-    ULONG recip_y = 0;
-    ULONG calc_width = 0;
-    ULONG calc_height = 0;
-    ULONG offset_x = 0;
-    ULONG offset_y = 0;
-    ULONG cnt = 0;
-    volatile ULONG *base = &dlist[offset];
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
 
     //bug("[unicam] UnicamConstructDL(%08lx, %lx)\n", (ULONG)dlist, offset);
 
     /* If no display list base was given, return required size for display list */
     if (dlist == NULL) {
-        if (UnicamBase->u_IsVC6) {
-            if (unity) {
-                return 9;
-            }
-            else {
-                return 18 + 11;
-            }
-        }
-        else {
-            if (unity) {
-                return 8;
-            }
-            else {
-                return 17 + 11;
-            }
-        }
+        return unicam_dl_size(UnicamBase);
     }
 
-    /* Check if unity scaling is to be applied, otherwise compute scaling factors and display offset */
-    if (UnicamBase->u_Size.width == UnicamBase->u_DisplaySize.width &&
-        UnicamBase->u_Size.height == UnicamBase->u_DisplaySize.height && UnicamBase->u_Aspect == 1000)
+    ObtainSemaphore(&UnicamBase->u_Lock);
+    MMIO_BEGIN(UnicamBase);
+
+    ULONG cnt = unicam_write_dl(UnicamBase, dlist, offset, 0, TRUE);
+
+    mmio_report(UnicamBase, "UnicamConstructDL");
+    ReleaseSemaphore(&UnicamBase->u_Lock);
+
+    return cnt;
+}
+
+/*
+    Register the plane written by the last UnicamConstructDL() at dlist[offset] as the one on screen.
+    From now on buffer flips and crop offset changes patch its address word, until the plane is
+    unregistered or another one registered. Returns FALSE, registering nothing, if the last plane
+    was written elsewhere.
+*/
+ULONG L_UnicamRegisterDL(REGARG(ULONG * dlist, "a0"), REGARG(ULONG offset, "d0"), REGARG(struct UnicamBase * UnicamBase, "a6"))
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+
+    ObtainSemaphore(&UnicamBase->u_Lock);
+
+    if (dlist == NULL || &dlist[offset] != UnicamBase->u_DLLastPlane)
     {
-        unity = 1;
+        ReleaseSemaphore(&UnicamBase->u_Lock);
+        return FALSE;
     }
-    else
-    {
-        scale_x = 0x10000 * ((UnicamBase->u_Size.width * UnicamBase->u_Aspect) / 1000) / UnicamBase->u_DisplaySize.width;
-        scale_y = 0x10000 * UnicamBase->u_Size.height / UnicamBase->u_DisplaySize.height;
 
-        recip_x = 0xffffffff / scale_x;
-        recip_y = 0xffffffff / scale_y;
+    Disable();
 
-        // Select larger scaling factor from X and Y, but it need to fit
-        if (((0x10000 * UnicamBase->u_Size.height) / scale_x) > UnicamBase->u_DisplaySize.height) {
-            scale = scale_y;
-        }
-        else {
-            scale = scale_x;
-        }
+    UnicamBase->u_DLPlane = &dlist[offset];
+    UnicamBase->u_DLAddressWord = UnicamBase->u_DLLastAddress;
 
-        if (UnicamBase->u_Integer)
-        {
-            scale = 0x10000 / (ULONG)(0x10000 / scale);
-        }
+    /* A flip could have happened since the plane was written */
+    unicam_update_address(UnicamBase);
 
-        scale_x = scale * 1000 / UnicamBase->u_Aspect;
-        scale_y = scale;
+    Enable();
 
-        calc_width = (0x10000 * UnicamBase->u_Size.width) / scale_x;
-        calc_height = (0x10000 * UnicamBase->u_Size.height) / scale_y;
+    ReleaseSemaphore(&UnicamBase->u_Lock);
 
-        if (calc_width > UnicamBase->u_DisplaySize.width) {
-            calc_width = UnicamBase->u_DisplaySize.width;
-        }
+    return TRUE;
+}
 
-        if (calc_height > UnicamBase->u_DisplaySize.height) {
-            calc_height = UnicamBase->u_DisplaySize.height;
-        }
+/* Stop patching the registered plane, has to be called before its memory is reused */
+void L_UnicamUnregisterDL(REGARG(struct UnicamBase * UnicamBase, "a6"))
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
 
-        offset_x = (UnicamBase->u_DisplaySize.width - calc_width) >> 1;
-        offset_y = (UnicamBase->u_DisplaySize.height - calc_height) >> 1;
-    }
+    ObtainSemaphore(&UnicamBase->u_Lock);
+    Disable();
 
-    ULONG startAddress = (ULONG)UnicamBase->u_ReceiveBuffer;
-    startAddress += UnicamBase->u_Offset.x * (UnicamBase->u_BPP / 8);
-    startAddress += UnicamBase->u_Offset.y * UnicamBase->u_FullSize.width * (UnicamBase->u_BPP / 8);
-
-    if (unity) {
-        if (UnicamBase->u_IsVC6) {
-            /* Set control reg */
-            ULONG control = 
-                VC6_CONTROL_VALID
-                | VC6_CONTROL_WORDS(8)
-                | VC6_CONTROL_UNITY
-                | VC6_CONTROL_ALPHA_EXPAND
-                | VC6_CONTROL_RGB_EXPAND;
-            
-            if (UnicamBase->u_PixelOrder == 0)
-                control |= VC6_CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XRGB);
-            else
-                control |= VC6_CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XBGR);
-
-            if (UnicamBase->u_BPP == 16)
-                control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_RGB565);
-            else if (UnicamBase->u_BPP == 24)
-                control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_RGB888);
-
-            wr32le(&base[cnt++], control);
-
-            /* Center it on the screen */
-            wr32le(&base[cnt++], VC6_POS0_X(offset_x) | VC6_POS0_Y(offset_y));
-            wr32le(&base[cnt++], (VC6_SCALER_POS2_ALPHA_MODE_FIXED << VC6_SCALER_POS2_ALPHA_MODE_SHIFT) | VC6_SCALER_POS2_ALPHA(0xfff));
-            wr32le(&base[cnt++], VC6_POS2_H(UnicamBase->u_Size.height) | VC6_POS2_W(UnicamBase->u_Size.width));
-            wr32le(&base[cnt++], 0xdeadbeef);
-
-            /* Set address */
-            wr32le(&base[cnt++], 0xc0000000 | startAddress);
-            wr32le(&base[cnt++], 0xdeadbeef);
-
-            /* Pitch is full width, always */
-            wr32le(&base[cnt++], UnicamBase->u_FullSize.width * (UnicamBase->u_BPP / 8));
-
-            /* Done */
-            wr32le(&base[cnt++], 0x80000000);
-        }
-        else {
-            /* Set control reg */
-            ULONG control = 
-                CONTROL_VALID
-                | CONTROL_WORDS(7)
-                | CONTROL_UNITY;
-
-            if (UnicamBase->u_PixelOrder == 0)
-                control |= CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XRGB);
-            else
-                control |= CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XBGR);
-
-            if (UnicamBase->u_BPP == 16)
-                control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_RGB565);
-            else if (UnicamBase->u_BPP == 24)
-                control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_RGB888);
-
-            wr32le(&base[cnt++], control);
-
-            /* Center it on the screen */
-            wr32le(&base[cnt++], POS0_X(offset_x) | POS0_Y(offset_y) | POS0_ALPHA(0xff));
-            wr32le(&base[cnt++], POS2_H(UnicamBase->u_Size.height) | POS2_W(UnicamBase->u_Size.width) | (1 << 30));
-            wr32le(&base[cnt++], 0xdeadbeef);
-
-            /* Set address */
-            wr32le(&base[cnt++], 0xc0000000 | (ULONG)startAddress);
-            wr32le(&base[cnt++], 0xdeadbeef);
-
-            /* Pitch is full width, always */
-            wr32le(&base[cnt++], UnicamBase->u_FullSize.width * (UnicamBase->u_BPP / 8));
-
-            /* Done */
-            wr32le(&base[cnt++], 0x80000000);
-        }
-    }
-    else
-    {
-        ULONG kernel_loc;
-
-        if (UnicamBase->u_IsVC6) {
-            /* Set control reg */
-            ULONG control = 
-                VC6_CONTROL_VALID
-                | VC6_CONTROL_WORDS(17)
-                | VC6_CONTROL_ALPHA_EXPAND
-                | VC6_CONTROL_RGB_EXPAND;
-            
-            if (UnicamBase->u_PixelOrder == 0)
-                control |= VC6_CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XRGB);
-            else
-                control |= VC6_CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XBGR);
-
-            if (UnicamBase->u_BPP == 16)
-                control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_RGB565);
-            else if (UnicamBase->u_BPP == 24)
-                control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_RGB888);
-
-            wr32le(&base[cnt++], control);
-
-            /* Center plane on the screen */
-            wr32le(&base[cnt++], VC6_POS0_X(offset_x) | VC6_POS0_Y(offset_y));
-            wr32le(&base[cnt++], (VC6_SCALER_POS2_ALPHA_MODE_FIXED << VC6_SCALER_POS2_ALPHA_MODE_SHIFT) | VC6_SCALER_POS2_ALPHA(0xfff));
-            wr32le(&base[cnt++], VC6_POS1_H(calc_height) | VC6_POS1_W(calc_width));
-            wr32le(&base[cnt++], VC6_POS2_H(UnicamBase->u_Size.height) | VC6_POS2_W(UnicamBase->u_Size.width));
-            wr32le(&base[cnt++], 0xdeadbeef); // Scratch written by HVS
-
-            /* Set address and pitch */
-            wr32le(&base[cnt++], 0xc0000000 | startAddress);
-            wr32le(&base[cnt++], 0xdeadbeef);
-
-            /* Pitch is full width, always */
-            wr32le(&base[cnt++], UnicamBase->u_FullSize.width * (UnicamBase->u_BPP / 8));
-
-            /* LMB address */
-            wr32le(&base[cnt++], 0);
-
-            /* Set PPF Scaler */
-            wr32le(&base[cnt++], (scale_x << 8) | ((ULONG)UnicamBase->u_Scaler << 30) | UnicamBase->u_Phase);
-            wr32le(&base[cnt++], (scale_y << 8) | ((ULONG)UnicamBase->u_Scaler << 30) | UnicamBase->u_Phase);
-            wr32le(&base[cnt++], 0); // Scratch written by HVS
-
-            kernel_loc = offset + cnt + 5;
-            
-            wr32le(&base[cnt++], kernel_loc);
-            wr32le(&base[cnt++], kernel_loc);
-            wr32le(&base[cnt++], kernel_loc);
-            wr32le(&base[cnt++], kernel_loc);
-
-            /* Done */
-            wr32le(&base[cnt++], 0x80000000);
-        }
-        else {
-            /* Set control reg */
-            ULONG control = 
-                CONTROL_VALID
-                | CONTROL_WORDS(16)
-                | 0x01800;
-
-            if (UnicamBase->u_PixelOrder == 0)
-                control |= CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XRGB);
-            else
-                control |= CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XBGR);
-
-            if (UnicamBase->u_BPP == 16)
-                control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_RGB565);
-            else if (UnicamBase->u_BPP == 24)
-                control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_RGB888);
-
-            wr32le(&base[cnt++], control);
-
-            /* Center plane on the screen */
-            wr32le(&base[cnt++], POS0_X(offset_x) | POS0_Y(offset_y) | POS0_ALPHA(0xff));
-            wr32le(&base[cnt++], POS1_H(calc_height) | POS1_W(calc_width));
-            wr32le(&base[cnt++], POS2_H(UnicamBase->u_Size.height) | POS2_W(UnicamBase->u_Size.width) |
-                                (SCALER_POS2_ALPHA_MODE_FIXED << SCALER_POS2_ALPHA_MODE_SHIFT));
-            wr32le(&base[cnt++], 0xdeadbeef); // Scratch written by HVS
-
-            /* Set address and pitch */
-            wr32le(&base[cnt++], 0xc0000000 | startAddress);
-            wr32le(&base[cnt++], 0xdeadbeef);
-
-            /* Pitch is full width, always */
-            wr32le(&base[cnt++], UnicamBase->u_FullSize.width * (UnicamBase->u_BPP / 8));
-
-            /* LMB address */
-            wr32le(&base[cnt++], 0);
-
-            /* Set PPF Scaler */
-            wr32le(&base[cnt++], (scale_x << 8) | (UnicamBase->u_Scaler << 30) | UnicamBase->u_Phase);
-            wr32le(&base[cnt++], (scale_y << 8) | (UnicamBase->u_Scaler << 30) | UnicamBase->u_Phase);
-            wr32le(&base[cnt++], 0); // Scratch written by HVS
-
-            kernel_loc = offset + cnt + 5;
-
-            wr32le(&base[cnt++], kernel_loc);
-            wr32le(&base[cnt++], kernel_loc);
-            wr32le(&base[cnt++], kernel_loc);
-            wr32le(&base[cnt++], kernel_loc);
-
-            /* Done */
-            wr32le(&base[cnt++], 0x80000000);
-        }
-
-        if (UnicamBase->u_Smooth)
-        {
-            LONG kernel_b = (UnicamBase->u_KernelB * 256) / 1000;
-            LONG kernel_c = (UnicamBase->u_KernelC * 256) / 1000;
-
-            compute_scaling_kernel(&dlist[kernel_loc], kernel_b, kernel_c);
-        }
-        else
-        {
-            compute_nearest_neighbour_kernel(&dlist[kernel_loc]);
-        }
-    }
+    UnicamBase->u_DLPlane = NULL;
+    UnicamBase->u_DLAddressWord = NULL;
 
-    return cnt;
+    Enable();
+    ReleaseSemaphore(&UnicamBase->u_Lock);
 }
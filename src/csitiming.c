@@ -0,0 +1,145 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+
+#include "unicam.h"
+
+/*
+    The TC358743 PLL runs from the 27MHz reference divided by CSI_PLL_PRD, so the bit rate per lane
+    can be set in 3 Mbps steps. The lowest rate is chosen which carries the active part of every line
+    with CSI_HEADROOM to spare, never more than the D-PHY of the bridge can do. The headroom is that
+    of the known-good 576p50 single lane setup, 822 Mbps.
+*/
+#define CSI_REFCLK      27000   // kHz
+#define CSI_PLL_PRD     9
+#define CSI_PLL_STEP    (CSI_REFCLK / CSI_PLL_PRD)
+#define CSI_RATE_MIN    62500   // kbps per lane
+#define CSI_RATE_MAX    1000000
+#define CSI_HEADROOM    520     // Per mille over the rate of active pixel data
+
+#define CSI_LINEINIT    110     // Line initialization wait, us (D-PHY minimum 100)
+#define CSI_WAKEUP      1100    // Wakeup from ULPS, us (D-PHY minimum 1000)
+
+/*
+    Transmitter timings as the D-PHY minimum in ns plus a number of UI. Register values are the
+    number of byte clocks covering that time plus an offset: some counters hold cycles minus one,
+    others are extended by the transmitter itself. Offsets are fitted so that the 822 Mbps reference
+    values come out unchanged.
+*/
+struct PhyParam {
+    UWORD   ns;
+    UBYTE   ui;
+    BYTE    adjust;
+};
+
+enum {
+    PHY_LPX, PHY_CLK_PREPARE, PHY_CLK_ZERO, PHY_CLK_TRAIL,
+    PHY_HS_PREPARE, PHY_HS_ZERO, PHY_CLK_POST, PHY_HS_TRAIL, PHY_COUNT
+};
+
+static const struct PhyParam phy_params[PHY_COUNT] = {
+    [PHY_LPX]           = {  50,  0, -1 },
+    [PHY_CLK_PREPARE]   = {  38,  0,  0 },
+    [PHY_CLK_ZERO]      = { 262,  0,  2 },  // CLK_PREPARE + CLK_ZERO >= 300ns
+    [PHY_CLK_TRAIL]     = {  60,  0, -5 },
+    [PHY_HS_PREPARE]    = {  40,  4, -1 },
+    [PHY_HS_ZERO]       = { 105,  6, -7 },  // HS_PREPARE + HS_ZERO >= 145ns + 10UI
+    [PHY_CLK_POST]      = {  60, 52, -3 },
+    [PHY_HS_TRAIL]      = {  60,  4, -3 },
+};
+
+/* Byte clocks covering ns + ui UI at given bit rate in kbps, rounded up. One byte clock is 8 UI */
+static ULONG byte_clocks(ULONG rate, ULONG ns, ULONG ui)
+{
+    ULONG mbps = rate / 1000;
+
+    return (ns * mbps + ui * 1000 + 7999) / 8000;
+}
+
+static ULONG phy_count(ULONG rate, int param)
+{
+    const struct PhyParam *p = &phy_params[param];
+    LONG count = byte_clocks(rate, p->ns, p->ui) + p->adjust;
+
+    return count > 0 ? count : 0;
+}
+
+/*
+    Compute PLL setup and transmitter timing for given pixel clock (10kHz units, as in EDID), active
+    and total line length, bpp and lane count. Returns FALSE if the mode does not fit into the lanes
+    even at the highest rate, timing for the highest rate is filled in then.
+*/
+BOOL csi_compute_timing(struct CSITiming *timing, ULONG pixclk, ULONG hactive, ULONG htotal, UBYTE bpp, UBYTE lanes)
+{
+    BOOL fits = TRUE;
+
+    if (lanes == 0)
+        lanes = 1;
+    if (htotal == 0 || htotal < hactive)
+        htotal = hactive;
+
+    /* Rate of active pixel data per lane in kbps, then with headroom */
+    ULONG data = pixclk * 10 * bpp / lanes;
+    if (htotal != 0)
+        data = data / htotal * hactive + (data % htotal) * hactive / htotal;
+    ULONG rate = data + data / 1000 * CSI_HEADROOM;
+
+    ULONG fbd = (rate + CSI_PLL_STEP - 1) / CSI_PLL_STEP;
+
+    if (fbd * CSI_PLL_STEP > CSI_RATE_MAX)
+    {
+        fbd = CSI_RATE_MAX / CSI_PLL_STEP;
+        fits = fbd * CSI_PLL_STEP >= data;
+    }
+    if (fbd * CSI_PLL_STEP < CSI_RATE_MIN)
+        fbd = (CSI_RATE_MIN + CSI_PLL_STEP - 1) / CSI_PLL_STEP;
+
+    rate = fbd * CSI_PLL_STEP;
+
+    /* Frequency range of the PLL output: 500-1000, 250-500, 125-250 and 62.5-125 Mbps */
+    UWORD frs = 0;
+    while (frs < 3 && rate <= (500000 >> frs))
+        frs++;
+
+    timing->ct_Rate = rate;
+    timing->ct_PLLCtl0 = ((CSI_PLL_PRD - 1) << 12) | (fbd - 1);
+    timing->ct_PLLCtl1 = (frs << 10) | 0x0213;  // Loop bandwidth 50%, clock enable, out of reset, PLL on
+
+    ULONG lpx = phy_count(rate, PHY_LPX);
+
+    timing->ct_LineInit = byte_clocks(rate, CSI_LINEINIT * 1000, 0);
+    timing->ct_LPTxTime = lpx;
+    timing->ct_TClkHeader = (phy_count(rate, PHY_CLK_ZERO) << 8) | phy_count(rate, PHY_CLK_PREPARE);
+    timing->ct_TClkTrail = phy_count(rate, PHY_CLK_TRAIL);
+    timing->ct_THSHeader = (phy_count(rate, PHY_HS_ZERO) << 8) | phy_count(rate, PHY_HS_PREPARE);
+    timing->ct_TWakeup = (byte_clocks(rate, CSI_WAKEUP * 1000, 0) + lpx) / (lpx + 1);  // In LP clocks
+    timing->ct_TClkPost = phy_count(rate, PHY_CLK_POST);
+    timing->ct_THSTrail = phy_count(rate, PHY_HS_TRAIL);
+
+    return fits;
+}
+
+/*
+    HS settle count of the Unicam receiver, aimed at the middle of the D-PHY THS-SETTLE window
+    (85ns + 6UI to 145ns + 10UI). The receiver counter ticks at about 20ns, which puts the count
+    used so far, 6, in the middle of the window at 822 Mbps. Without a known rate that value is kept.
+*/
+#define UNICAM_SETTLE_TICK  20  // ns
+
+UBYTE csi_ths_settle(ULONG rate)
+{
+    ULONG mbps = rate / 1000;
+
+    if (mbps == 0)
+        return 6;
+
+    /* (115ns + 8UI) / tick, rounded */
+    return (115 * mbps + 8000 + UNICAM_SETTLE_TICK / 2 * mbps) / (UNICAM_SETTLE_TICK * mbps);
+}
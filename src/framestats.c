@@ -0,0 +1,99 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+
+#include "framestats.h"
+
+/* Forget the frames seen so far, the gap until the next frame end is not a period */
+void framestats_reset(struct FrameStats *stats)
+{
+    stats->fs_Start = stats->fs_Head;
+}
+
+void framestats_end(struct FrameStats *stats, ULONG now)
+{
+    ULONG head = stats->fs_Head;
+
+    stats->fs_Ring[head & (FRAME_STATS_SIZE - 1)] = now;
+    stats->fs_Head = head + 1;
+}
+
+/* Take a consistent copy of the newest entries, returns number of entries copied */
+static ULONG snapshot(const struct FrameStats *stats, ULONG *copy, ULONG *head_out)
+{
+    ULONG head;
+    ULONG start;
+    ULONG count;
+    int retry = 4;
+
+    do {
+        head = stats->fs_Head;
+        start = stats->fs_Start;
+        count = head - start < FRAME_STATS_SIZE ? head - start : FRAME_STATS_SIZE;
+
+        for (ULONG i=0; i < count; i++)
+        {
+            copy[i] = stats->fs_Ring[(head - count + i) & (FRAME_STATS_SIZE - 1)];
+        }
+    } while ((stats->fs_Head != head || stats->fs_Start != start) && --retry);
+
+    *head_out = head;
+
+    return count;
+}
+
+void framestats_compute(const struct FrameStats *stats, struct UnicamStats *out)
+{
+    ULONG copy[FRAME_STATS_SIZE];
+    ULONG head;
+    ULONG count = snapshot(stats, copy, &head);
+    ULONG period_min = 0xffffffff;
+    ULONG period_max = 0;
+    ULONG period_sum = 0;
+    ULONG period_cnt = 0;
+    ULONG dropped = 0;
+
+    out->us_Sequence = head;
+    out->us_Frames = count;
+
+    for (ULONG i=1; i < count; i++)
+    {
+        ULONG period = copy[i] - copy[i - 1];
+        if (period < period_min) period_min = period;
+    }
+
+    /*
+        The shortest period is taken as nominal one. Periods longer than 1.5 of it are counted
+        as dropped frames and do not contribute to average and maximum.
+    */
+    for (ULONG i=1; i < count; i++)
+    {
+        ULONG period = copy[i] - copy[i - 1];
+
+        if (period > period_min + (period_min >> 1))
+        {
+            dropped += (period + (period_min >> 1)) / period_min - 1;
+        }
+        else
+        {
+            if (period > period_max) period_max = period;
+            period_sum += period;
+            period_cnt++;
+        }
+    }
+
+    if (period_cnt == 0)
+        period_min = 0;
+
+    out->us_PeriodMin = period_min;
+    out->us_PeriodAvg = period_cnt ? period_sum / period_cnt : 0;
+    out->us_PeriodMax = period_max;
+    out->us_Dropped = dropped;
+}
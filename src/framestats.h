@@ -0,0 +1,25 @@
+#ifndef _FRAMESTATS_H
+#define _FRAMESTATS_H
+
+#include <exec/types.h>
+#include <resources/unicam.h>
+
+/* Number of frames kept in the timing ring, has to be a power of two */
+#define FRAME_STATS_SIZE    64
+
+/*
+    Single producer ring of frame end times. Entries are written from the interrupt server only,
+    fs_Head is advanced after the entry is complete. Readers take a snapshot and retry if the head
+    moved meanwhile. Only frames from fs_Start on are used, fs_Head keeps counting the sequence.
+*/
+struct FrameStats {
+    volatile ULONG      fs_Head;
+    volatile ULONG      fs_Start;
+    ULONG               fs_Ring[FRAME_STATS_SIZE];
+};
+
+void framestats_reset(struct FrameStats *stats);
+void framestats_end(struct FrameStats *stats, ULONG now);
+void framestats_compute(const struct FrameStats *stats, struct UnicamStats *out);
+
+#endif /* _FRAMESTATS_H */
@@ -0,0 +1,80 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+#include <common/compiler.h>
+
+#include <proto/exec.h>
+
+#include "unicam.h"
+#include "vc4-regs-unicam.h"
+
+/*
+    Number of frame buffers the receive buffer is split into. The receive buffer is never replaced
+    here, so that pointers from UnicamGetFramebuffer() stay valid. It grows on the next UnicamStart()
+    into it, until then as many buffers are used as fit.
+*/
+void L_UnicamSetBuffers(REGARG(UBYTE count, "d0"), REGARG(struct UnicamBase * UnicamBase, "a6"))
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+
+    if (count < 1)
+        count = 1;
+    if (count > UNICAM_MAX_BUFFERS)
+        count = UNICAM_MAX_BUFFERS;
+
+    ObtainSemaphore(&UnicamBase->u_Lock);
+    unicam_release_retired(UnicamBase);
+
+    Disable();
+
+    UnicamBase->u_BufferCount = count;
+
+    /*
+        If capture is running, split the buffer again. Slots do not move, only their number changes.
+        With a different number, the buffer latched by hardware may not be part of the new split, so
+        capture is restarted into the slot following the displayed one and the display list follows.
+    */
+    if (UnicamBase->u_Running)
+    {
+        UBYTE active = UnicamBase->u_ActiveBuffers;
+        UBYTE write = UnicamBase->u_WriteBuffer;
+        UBYTE display = UnicamBase->u_DisplayBuffer;
+        UBYTE queued = UnicamBase->u_QueuedBuffer;
+
+        unicam_setup_buffers(UnicamBase);
+
+        if (UnicamBase->u_ActiveBuffers == active)
+        {
+            UnicamBase->u_WriteBuffer = write;
+            UnicamBase->u_DisplayBuffer = display;
+            UnicamBase->u_QueuedBuffer = queued;
+        }
+        else
+        {
+            UnicamBase->u_DisplayBuffer = display < UnicamBase->u_ActiveBuffers ? display : 0;
+            unicam_restart(UnicamBase);
+            UnicamBase->u_LastIBWP = ReadReg(UnicamBase, UNICAM_IBWP);
+            UnicamBase->u_LastProgress = systimer_read();
+            unicam_update_address(UnicamBase);
+        }
+    }
+
+    Enable();
+
+    ReleaseSemaphore(&UnicamBase->u_Lock);
+}
+
+UBYTE L_UnicamGetBuffers(REGARG(struct UnicamBase * UnicamBase, "a6"))
+{
+    if (UnicamBase->u_Running)
+        return UnicamBase->u_ActiveBuffers;
+    else
+        return UnicamBase->u_BufferCount;
+}
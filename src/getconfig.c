@@ -20,6 +20,7 @@ ULONG L_UnicamGetConfig(REGARG(struct UnicamBase * UnicamBase, "a6"))
     if (UnicamBase->u_Integer) cfg |= UNICAMF_INTEGER;
     if (UnicamBase->u_Smooth) cfg |= UNICAMF_SMOOTHING;
     if (UnicamBase->u_StartOnBoot) cfg |= UNICAMF_BOOT;
+    if (UnicamBase->u_Window) cfg |= UNICAMF_WINDOW;
 
     cfg |= (UnicamBase->u_Scaler << UNICAMB_SCALER) & UNICAMF_SCALER;
     cfg |= (UnicamBase->u_Phase << UNICAMB_PHASE) & UNICAMF_PHASE;
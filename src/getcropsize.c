@@ -10,6 +10,8 @@
 #include <exec/types.h>
 #include <common/compiler.h>
 
+#include <proto/exec.h>
+
 #include "unicam.h"
 #include "mbox.h"
 
@@ -29,14 +31,53 @@ ULONG L_UnicamGetCropOffset(REGARG(struct UnicamBase * UnicamBase, "a6"))
 
 void L_UnicamSetCropSize(REGARG(UWORD width, "d0"), REGARG(UWORD height, "d1"), REGARG(struct UnicamBase * UnicamBase, "a6"))
 {
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+
+    ObtainSemaphore(&UnicamBase->u_Lock);
+
     if (width <= UnicamBase->u_FullSize.width && height <= UnicamBase->u_FullSize.height) {
         UnicamBase->u_Size.width = width;
         UnicamBase->u_Size.height = height;
+        UnicamBase->u_WindowPending = UnicamBase->u_Running && UnicamBase->u_Window;
+        UnicamBase->u_Generation++;
     }
+
+    ReleaseSemaphore(&UnicamBase->u_Lock);
 }
 
-void L_UnicamSetCropOffset(REGARG(ULONG x, "d0"), REGARG(ULONG y, "d1"), REGARG(struct UnicamBase * UnicamBase, "a6"))
+/*
+    Only the start address of the plane depends on the crop offset. If the display list is live, the
+    address word is patched in place instead of rebuilding the list. While capture is running the
+    update is left to the vertical blank server, so that the window moves between two frames. With
+    the capture window enabled the server moves the window of Unicam as well.
+*/
+void L_UnicamSetCropOffset(REGARG(UWORD x, "d0"), REGARG(UWORD y, "d1"), REGARG(struct UnicamBase * UnicamBase, "a6"))
 {
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+
+    ObtainSemaphore(&UnicamBase->u_Lock);
+
+    /* Keep the cropped window inside the captured frame */
+    if (x + UnicamBase->u_Size.width > UnicamBase->u_FullSize.width)
+        x = UnicamBase->u_FullSize.width - UnicamBase->u_Size.width;
+    if (y + UnicamBase->u_Size.height > UnicamBase->u_FullSize.height)
+        y = UnicamBase->u_FullSize.height - UnicamBase->u_Size.height;
+
+    Disable();
+
     UnicamBase->u_Offset.x = x;
     UnicamBase->u_Offset.y = y;
+
+    /* The capture window follows the crop offset */
+    if (UnicamBase->u_Running && UnicamBase->u_Window)
+        UnicamBase->u_WindowPending = TRUE;
+
+    if (UnicamBase->u_IntInstalled)
+        UnicamBase->u_OffsetPending = TRUE;
+    else
+        unicam_update_address(UnicamBase);
+
+    Enable();
+
+    ReleaseSemaphore(&UnicamBase->u_Lock);
 }
@@ -0,0 +1,34 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+#include <common/compiler.h>
+
+#include <proto/exec.h>
+
+#include "unicam.h"
+
+void L_UnicamGetErrors(REGARG(struct UnicamErrors * errors, "a0"), REGARG(ULONG reset, "d0"), REGARG(struct UnicamBase * UnicamBase, "a6"))
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+    ULONG *src = (ULONG *)&UnicamBase->u_Errors;
+    ULONG *dst = (ULONG *)errors;
+
+    Disable();
+
+    for (int i=0; i < sizeof(struct UnicamErrors) / sizeof(ULONG); i++)
+    {
+        if (dst != NULL)
+            dst[i] = src[i];
+        if (reset)
+            src[i] = 0;
+    }
+
+    Enable();
+}
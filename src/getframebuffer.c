@@ -18,6 +18,12 @@ APTR L_UnicamGetFramebuffer(REGARG(struct UnicamBase * UnicamBase, "a6"))
     return UnicamBase->u_ReceiveBuffer;
 }
 
+/* Distance between lines of the frame buffer in bytes, lines may be padded past the visible width */
+ULONG L_UnicamGetStride(REGARG(struct UnicamBase * UnicamBase, "a6"))
+{
+    return unicam_stride(UnicamBase);
+}
+
 ULONG L_UnicamGetFramebufferSize(REGARG(struct UnicamBase * UnicamBase, "a6"))
 {
     return UnicamBase->u_ReceiveBufferSize;
@@ -0,0 +1,22 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+#include <common/compiler.h>
+
+#include "unicam.h"
+
+/*
+    Generation of the display configuration. It changes whenever a setter modifies anything the
+    display list depends on, so callers may skip UnicamConstructDL() while it stays the same.
+*/
+ULONG L_UnicamGetGeneration(REGARG(struct UnicamBase * UnicamBase, "a6"))
+{
+    return UnicamBase->u_Generation;
+}
@@ -25,11 +25,31 @@ void L_UnicamSetKernel(REGARG(UWORD b, "d0"), REGARG(UWORD c, "d1"), REGARG(stru
 {
     UnicamBase->u_KernelB = b;
     UnicamBase->u_KernelC = c;
+    UnicamBase->u_Generation++;
 }
 
 void L_UnicamSetAspect(REGARG(UWORD aspect, "d0"), REGARG(struct UnicamBase * UnicamBase, "a6"))
 {
     UnicamBase->u_Aspect = aspect;
+    UnicamBase->u_Generation++;
+}
+
+/* Filters of horizontal and vertical scaler, UNICAM_FILTER_* */
+void L_UnicamSetFilter(REGARG(UBYTE horizontal, "d0"), REGARG(UBYTE vertical, "d1"), REGARG(struct UnicamBase * UnicamBase, "a6"))
+{
+    if (horizontal < UNICAM_FILTER_COUNT && vertical < UNICAM_FILTER_COUNT) {
+        UnicamBase->u_FilterH = horizontal;
+        UnicamBase->u_FilterV = vertical;
+        UnicamBase->u_Generation++;
+    }
+}
+
+ULONG L_UnicamGetFilter(REGARG(struct UnicamBase * UnicamBase, "a6"))
+{
+    ULONG filter = UnicamBase->u_FilterH;
+    filter = (filter << 16) | UnicamBase->u_FilterV;
+
+    return filter;
 }
 
 UWORD L_UnicamGetAspect(REGARG(struct UnicamBase * UnicamBase, "a6"))
@@ -0,0 +1,22 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+#include <common/compiler.h>
+
+#include "unicam.h"
+#include "framestats.h"
+
+void L_UnicamGetStats(REGARG(struct UnicamStats * stats, "a0"), REGARG(struct UnicamBase * UnicamBase, "a6"))
+{
+    if (stats != NULL)
+    {
+        framestats_compute(&UnicamBase->u_FrameStats, stats);
+    }
+}
@@ -0,0 +1,227 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+#include <common/compiler.h>
+
+#include <proto/exec.h>
+
+#include "unicam.h"
+
+/* A grab overtaken by the capture is repeated this many times before the last copy is returned */
+#define GRAB_RETRIES    3
+
+static const UBYTE grab_bpp[UNICAM_GRAB_COUNT] = { 3, 3, 4, 4, 2, 2 };
+
+/*
+    Straight copy of a line. If both ends are 16 byte aligned, which a padded stride gives for the
+    source, the bulk goes through MOVE16 and does not pollute the data cache.
+*/
+static void copy_line(UBYTE *dst, const UBYTE *src, ULONG len)
+{
+#ifndef UNICAM_HOST
+    if ((((ULONG)dst | (ULONG)src) & 15) == 0)
+    {
+        for (ULONG blocks = len >> 4; blocks != 0; blocks--)
+            asm volatile("move16 (%0)+,(%1)+" : "+a"(src), "+a"(dst) : : "memory");
+
+        len &= 15;
+    }
+#endif
+
+    if ((((ULONG)dst | (ULONG)src) & 3) == 0)
+    {
+        for (; len >= 16; len -= 16)
+        {
+            ((ULONG *)dst)[0] = ((const ULONG *)src)[0];
+            ((ULONG *)dst)[1] = ((const ULONG *)src)[1];
+            ((ULONG *)dst)[2] = ((const ULONG *)src)[2];
+            ((ULONG *)dst)[3] = ((const ULONG *)src)[3];
+            dst += 16;
+            src += 16;
+        }
+    }
+
+    while (len--)
+        *dst++ = *src++;
+}
+
+/*
+    Source pixels. Captured RGB888 is B, G, R in memory for pixel order XRGB and R, G, B for XBGR,
+    captured RGB565 is little endian with red or blue in the upper bits. Components are expanded to
+    8 bits, ri and bi select where red and blue come from.
+*/
+#define FETCH24 \
+    r = s[ri]; g = s[1]; b = s[bi]; s += 3;
+
+#define FETCH16 \
+    { \
+        ULONG w = s[0] | (s[1] << 8); \
+        s += 2; \
+        r = (w >> ri) & 0x1f; r = (r << 3) | (r >> 2); \
+        g = (w >> 5) & 0x3f; g = (g << 2) | (g >> 4); \
+        b = (w >> bi) & 0x1f; b = (b << 3) | (b >> 2); \
+    }
+
+#define STORE_RGB24     d[0] = r; d[1] = g; d[2] = b; d += 3;
+#define STORE_BGR24     d[0] = b; d[1] = g; d[2] = r; d += 3;
+#define STORE_ARGB32    d[0] = 0xff; d[1] = r; d[2] = g; d[3] = b; d += 4;
+#define STORE_BGRA32    d[0] = b; d[1] = g; d[2] = r; d[3] = 0xff; d += 4;
+#define STORE_RGB16     d[0] = (r & 0xf8) | (g >> 5); d[1] = ((g << 3) & 0xe0) | (b >> 3); d += 2;
+#define STORE_RGB16PC   d[1] = (r & 0xf8) | (g >> 5); d[0] = ((g << 3) & 0xe0) | (b >> 3); d += 2;
+
+/* Inner loop unrolled to four pixels, the switch over formats stays outside of it */
+#define CONVERT(FETCH, STORE) \
+    for (; n >= 4; n -= 4) { FETCH STORE FETCH STORE FETCH STORE FETCH STORE } \
+    for (; n != 0; n--) { FETCH STORE } \
+    break;
+
+static void convert_line(UBYTE *d, const UBYTE *s, ULONG n, UBYTE bpp, UBYTE order, ULONG format)
+{
+    ULONG r, g, b;
+    ULONG ri, bi;
+
+    if (bpp == 24)
+    {
+        ri = order == 0 ? 2 : 0;
+        bi = 2 - ri;
+
+        switch (format)
+        {
+            case UNICAM_GRAB_RGB24:     CONVERT(FETCH24, STORE_RGB24)
+            case UNICAM_GRAB_BGR24:     CONVERT(FETCH24, STORE_BGR24)
+            case UNICAM_GRAB_ARGB32:    CONVERT(FETCH24, STORE_ARGB32)
+            case UNICAM_GRAB_BGRA32:    CONVERT(FETCH24, STORE_BGRA32)
+            case UNICAM_GRAB_RGB16:     CONVERT(FETCH24, STORE_RGB16)
+            case UNICAM_GRAB_RGB16PC:   CONVERT(FETCH24, STORE_RGB16PC)
+        }
+    }
+    else
+    {
+        ri = order == 0 ? 11 : 0;
+        bi = 11 - ri;
+
+        switch (format)
+        {
+            case UNICAM_GRAB_RGB24:     CONVERT(FETCH16, STORE_RGB24)
+            case UNICAM_GRAB_BGR24:     CONVERT(FETCH16, STORE_BGR24)
+            case UNICAM_GRAB_ARGB32:    CONVERT(FETCH16, STORE_ARGB32)
+            case UNICAM_GRAB_BGRA32:    CONVERT(FETCH16, STORE_BGRA32)
+            case UNICAM_GRAB_RGB16:     CONVERT(FETCH16, STORE_RGB16)
+            case UNICAM_GRAB_RGB16PC:   CONVERT(FETCH16, STORE_RGB16PC)
+        }
+    }
+}
+
+/* Captured lines which already are in the requested format */
+static BOOL is_copy(UBYTE bpp, UBYTE order, ULONG format)
+{
+    if (bpp == 24)
+        return format == (order == 0 ? UNICAM_GRAB_BGR24 : UNICAM_GRAB_RGB24);
+    else
+        return order == 0 && format == UNICAM_GRAB_RGB16PC;
+}
+
+/*
+    Copy a rectangle of the newest complete frame to dest, lines packed one after another, converted
+    to given format. Without rect the crop rectangle is grabbed. While capture runs the call waits for
+    a frame end and copies the frame shown on screen. With more than one capture buffer the copy is
+    repeated if the capture has come back to that buffer in the meantime, with a single buffer the
+    grab races with the capture of next frame. Returns number of bytes written, 0 if the frame cannot
+    be grabbed: YUV capture, unknown format, the rectangle outside of captured data or no frame
+    arriving.
+*/
+static ULONG grab_frame(APTR dest, ULONG format, struct UnicamRect *rect, struct UnicamBase * UnicamBase)
+{
+    UBYTE bpp = UnicamBase->u_BPP;
+    UBYTE order = UnicamBase->u_PixelOrder;
+    struct Point offset;
+    struct Size size;
+    ULONG x, y, width, height;
+
+    if (format >= UNICAM_GRAB_COUNT || UNICAM_IS_YUV(UnicamBase) || (bpp != 16 && bpp != 24))
+        return 0;
+
+    if (rect != NULL)
+    {
+        x = rect->ur_X;
+        y = rect->ur_Y;
+        width = rect->ur_Width;
+        height = rect->ur_Height;
+    }
+    else
+    {
+        x = UnicamBase->u_Offset.x;
+        y = UnicamBase->u_Offset.y;
+        width = UnicamBase->u_Size.width;
+        height = UnicamBase->u_Size.height;
+    }
+
+    /* Only the capture window is in memory */
+    unicam_get_window(UnicamBase, &offset, &size);
+
+    if (width == 0 || height == 0 || x < offset.x || y < offset.y ||
+        x + width > offset.x + size.width || y + height > offset.y + size.height)
+    {
+        return 0;
+    }
+
+    ULONG stride = unicam_stride(UnicamBase);
+    ULONG dest_line = width * grab_bpp[format];
+    BOOL copy = is_copy(bpp, order, format);
+
+    for (int attempt = 0; attempt <= GRAB_RETRIES; attempt++)
+    {
+        ULONG sequence = L_UnicamWaitFrame(UnicamBase);
+
+        if (sequence == UNICAM_WAIT_TIMEOUT)
+            return 0;
+
+        UBYTE count = UnicamBase->u_ActiveBuffers;
+        const UBYTE *src = count != 0 ? UnicamBase->u_Buffers[UnicamBase->u_DisplayBuffer] : UnicamBase->u_ReceiveBuffer;
+        UBYTE *dst = dest;
+
+        src += (y - offset.y) * stride + (x - offset.x) * (bpp / 8);
+
+        for (ULONG line = 0; line < height; line++)
+        {
+            if (copy)
+                copy_line(dst, src, dest_line);
+            else
+                convert_line(dst, src, width, bpp, order, format);
+
+            src += stride;
+            dst += dest_line;
+        }
+
+        /*
+            Displayed buffer is queued for capture again after count - 2 frame ends and latched at the
+            start following the next one. The sequence advances only at the vertical blank poll, which
+            may come a frame after that start, so the copy is complete only if no more than count - 3
+            frames have ended. With two buffers that is never certain and the last copy is returned.
+        */
+        if (!UnicamBase->u_Running || count < 2 || UnicamBase->u_FrameSequence - sequence + 3 <= count)
+            break;
+    }
+
+    return dest_line * height;
+}
+
+/* Receive buffer cannot be replaced by the input mode monitor while it is copied */
+ULONG L_UnicamGrabFrame(REGARG(APTR dest, "a0"), REGARG(ULONG format, "d0"), REGARG(struct UnicamRect * rect, "a1"),
+                        REGARG(struct UnicamBase * UnicamBase, "a6"))
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+
+    ObtainSemaphore(&UnicamBase->u_Lock);
+    ULONG bytes = grab_frame(dest, format, rect, UnicamBase);
+    ReleaseSemaphore(&UnicamBase->u_Lock);
+
+    return bytes;
+}
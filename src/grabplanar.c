@@ -0,0 +1,245 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+#include <graphics/gfx.h>
+#include <common/compiler.h>
+
+#include <proto/exec.h>
+
+#include "unicam.h"
+
+/*
+    Colour index of a captured pixel. The index is split into red, green and blue fields of
+    (depth + 1) / 3, (depth + 2) / 3 and depth / 3 bits, green having most of them: RGB332 on an
+    8 plane screen, RGB222 on a 6 plane one. With UNICAM_PLANARF_GREY it is the luminance instead.
+*/
+struct Quantizer {
+    UBYTE   q_RedShift;     // Red, green and blue are shifted right by these...
+    UBYTE   q_GreenShift;
+    UBYTE   q_BlueShift;
+    UBYTE   q_RedPos;       // ...and left to their place in the index
+    UBYTE   q_GreenPos;
+    UBYTE   q_GreyShift;
+    BOOL    q_Grey;
+    UBYTE   q_RedByte;      // Offset of red and blue in a RGB888 pixel, shift in a RGB565 one
+    UBYTE   q_BlueByte;
+    UBYTE   q_BPP;
+};
+
+static void setup_quantizer(struct Quantizer *q, UBYTE depth, UBYTE bpp, UBYTE order, ULONG flags)
+{
+    UBYTE red = (depth + 1) / 3;
+    UBYTE green = (depth + 2) / 3;
+    UBYTE blue = depth / 3;
+
+    q->q_RedShift = 8 - red;
+    q->q_GreenShift = 8 - green;
+    q->q_BlueShift = 8 - blue;
+    q->q_RedPos = green + blue;
+    q->q_GreenPos = blue;
+    q->q_GreyShift = 8 - depth;
+    q->q_Grey = (flags & UNICAM_PLANARF_GREY) != 0;
+    q->q_BPP = bpp;
+
+    /* Same pixel layouts as for UnicamGrabFrame() */
+    if (bpp == 24)
+    {
+        q->q_RedByte = order == 0 ? 2 : 0;
+        q->q_BlueByte = 2 - q->q_RedByte;
+    }
+    else
+    {
+        q->q_RedByte = order == 0 ? 11 : 0;
+        q->q_BlueByte = 11 - q->q_RedByte;
+    }
+}
+
+static inline ULONG quantize(const struct Quantizer *q, const UBYTE *p)
+{
+    ULONG r, g, b;
+
+    if (q->q_BPP == 24)
+    {
+        r = p[q->q_RedByte];
+        g = p[1];
+        b = p[q->q_BlueByte];
+    }
+    else
+    {
+        ULONG w = p[0] | (p[1] << 8);
+
+        r = ((w >> q->q_RedByte) & 0x1f) << 3;
+        g = ((w >> 5) & 0x3f) << 2;
+        b = ((w >> q->q_BlueByte) & 0x1f) << 3;
+    }
+
+    if (q->q_Grey)
+        return ((77 * r + 150 * g + 29 * b) >> 8) >> q->q_GreyShift;
+
+    return ((r >> q->q_RedShift) << q->q_RedPos) | ((g >> q->q_GreenShift) << q->q_GreenPos) | (b >> q->q_BlueShift);
+}
+
+/*
+    Transpose eight chunky pixels to one byte of each plane by merging: bit pairs, then pairs of
+    pairs, then nibbles are swapped across the two halves. Pixel 0 ends up in the top bit of each
+    plane byte, plane 7 comes out first.
+*/
+static void c2p8(const UBYTE *chunky, UBYTE *out)
+{
+    ULONG x = (chunky[0] << 24) | (chunky[1] << 16) | (chunky[2] << 8) | chunky[3];
+    ULONG y = (chunky[4] << 24) | (chunky[5] << 16) | (chunky[6] << 8) | chunky[7];
+    ULONG t;
+
+    t = (x ^ (x >> 7)) & 0x00aa00aa; x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00aa00aa; y = y ^ t ^ (t << 7);
+
+    t = (x ^ (x >> 14)) & 0x0000cccc; x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000cccc; y = y ^ t ^ (t << 14);
+
+    t = (x & 0xf0f0f0f0) | ((y >> 4) & 0x0f0f0f0f);
+    y = ((x << 4) & 0xf0f0f0f0) | (y & 0x0f0f0f0f);
+    x = t;
+
+    out[0] = x >> 24; out[1] = x >> 16; out[2] = x >> 8; out[3] = x;
+    out[4] = y >> 24; out[5] = y >> 16; out[6] = y >> 8; out[7] = y;
+}
+
+/*
+    Convert the captured frame into a planar bitmap of up to 8 planes. The source rectangle, crop
+    rectangle if NULL, is scaled to the size of the whole bitmap with nearest neighbour sampling.
+    The bitmap does not know its width in pixels, rows may be padded. Width 0 takes the whole row,
+    BytesPerRow / Depth of it for an interleaved bitmap. Only the region of the bitmap is written,
+    whole bitmap if NULL, so that a preview can refresh the part which changed. Region is extended
+    to multiples of 8 pixels horizontally, pixels past the width repeat the last one. Unless
+    UNICAM_PLANARF_NOWAIT is given, the call waits for a frame end and converts the frame on screen.
+    Returns the number of pixels written, 0 if the frame cannot be converted or no frame arrives.
+*/
+static ULONG grab_planar(struct BitMap *bm, struct UnicamRect *src, struct UnicamRect *region, ULONG flags,
+                         ULONG width, struct UnicamBase * UnicamBase)
+{
+    UBYTE bpp = UnicamBase->u_BPP;
+    UBYTE depth = bm->Depth;
+    ULONG row = depth != 0 && (bm->Flags & BMF_INTERLEAVED) ? bm->BytesPerRow / depth : bm->BytesPerRow;
+    ULONG bm_width = width != 0 && width < row * 8 ? width : row * 8;
+    ULONG bm_bytes = (bm_width + 7) >> 3;
+    ULONG bm_height = bm->Rows;
+    struct Quantizer q;
+    struct Point offset;
+    struct Size size;
+    ULONG sx, sy, sw, sh;
+    ULONG x0, y0, x1, y1;
+
+    if (depth == 0 || depth > 8 || bm_width == 0 || bm_height == 0 || UNICAM_IS_YUV(UnicamBase) || (bpp != 16 && bpp != 24))
+        return 0;
+
+    if (src != NULL)
+    {
+        sx = src->ur_X;
+        sy = src->ur_Y;
+        sw = src->ur_Width;
+        sh = src->ur_Height;
+    }
+    else
+    {
+        sx = UnicamBase->u_Offset.x;
+        sy = UnicamBase->u_Offset.y;
+        sw = UnicamBase->u_Size.width;
+        sh = UnicamBase->u_Size.height;
+    }
+
+    unicam_get_window(UnicamBase, &offset, &size);
+
+    if (sw == 0 || sh == 0 || sx < offset.x || sy < offset.y ||
+        sx + sw > offset.x + size.width || sy + sh > offset.y + size.height)
+    {
+        return 0;
+    }
+
+    if (region != NULL)
+    {
+        x0 = region->ur_X & ~7UL;
+        y0 = region->ur_Y;
+        x1 = (region->ur_X + region->ur_Width + 7) & ~7UL;
+        y1 = region->ur_Y + region->ur_Height;
+
+        if (x1 > bm_bytes * 8)
+            x1 = bm_bytes * 8;
+        if (y1 > bm_height)
+            y1 = bm_height;
+        if (x0 >= x1 || y0 >= y1)
+            return 0;
+    }
+    else
+    {
+        x0 = 0;
+        y0 = 0;
+        x1 = bm_bytes * 8;
+        y1 = bm_height;
+    }
+
+    setup_quantizer(&q, depth, bpp, UnicamBase->u_PixelOrder, flags);
+
+    if (!(flags & UNICAM_PLANARF_NOWAIT) && L_UnicamWaitFrame(UnicamBase) == UNICAM_WAIT_TIMEOUT)
+        return 0;
+
+    ULONG stride = unicam_stride(UnicamBase);
+    ULONG pixel = bpp / 8;
+    const UBYTE *frame = UnicamBase->u_ActiveBuffers != 0 ?
+        UnicamBase->u_Buffers[UnicamBase->u_DisplayBuffer] : UnicamBase->u_ReceiveBuffer;
+
+    frame += (sy - offset.y) * stride + (sx - offset.x) * pixel;
+
+    /* Source position in 16.16 fixed point, sampled in the middle of each destination pixel */
+    ULONG step_x = (sw << 16) / bm_width;
+    ULONG step_y = (sh << 16) / bm_height;
+    ULONG last_x = (sw - 1) * pixel;
+
+    for (ULONG y = y0; y < y1; y++)
+    {
+        const UBYTE *line = frame + ((y * step_y + (step_y >> 1)) >> 16) * stride;
+        ULONG pos = x0 * step_x + (step_x >> 1);
+        ULONG byte = y * bm->BytesPerRow + (x0 >> 3);
+
+        for (ULONG x = x0; x < x1; x += 8, byte++)
+        {
+            UBYTE chunky[8];
+            UBYTE planes[8];
+
+            for (int i=0; i < 8; i++)
+            {
+                ULONG sample = (pos >> 16) * pixel;
+
+                chunky[i] = quantize(&q, line + (sample < last_x ? sample : last_x));
+                pos += step_x;
+            }
+
+            c2p8(chunky, planes);
+
+            for (int p=0; p < depth; p++)
+                bm->Planes[p][byte] = planes[7 - p];
+        }
+    }
+
+    return (x1 - x0) * (y1 - y0);
+}
+
+/* Receive buffer cannot be replaced by the input mode monitor while it is converted */
+ULONG L_UnicamGrabPlanar(REGARG(struct BitMap * bm, "a0"), REGARG(struct UnicamRect * src, "a1"),
+                         REGARG(struct UnicamRect * region, "a2"), REGARG(ULONG flags, "d0"),
+                         REGARG(ULONG width, "d1"), REGARG(struct UnicamBase * UnicamBase, "a6"))
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+
+    ObtainSemaphore(&UnicamBase->u_Lock);
+    ULONG pixels = grab_planar(bm, src, region, flags, width, UnicamBase);
+    ReleaseSemaphore(&UnicamBase->u_Lock);
+
+    return pixels;
+}
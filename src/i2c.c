@@ -0,0 +1,143 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+
+#include "unicam.h"
+#include "i2c.h"
+
+/* Program BSC clock divider for I2C_SPEED. Divider is even, rounded up so the bus is never overclocked */
+void i2c_set_speed(volatile tI2cRegs *pI2c, ULONG core_clock)
+{
+    ULONG div = (core_clock + I2C_SPEED - 1) / I2C_SPEED;
+
+    wr32le(&pI2c->DIV, (div + 1) & ~1);
+}
+
+/* Stop the controller after a timeout. Clearing I2CEN ends the transfer, FIFO is flushed */
+static ULONG i2c_abort(volatile tI2cRegs *pI2c)
+{
+    wr32le(&pI2c->C, I2C_C_CLEAR_FIFO_ONE_SHOT);
+    wr32le(&pI2c->S, I2C_S_CLKT | I2C_S_ERR | I2C_S_DONE);
+
+    return RESULT(0, SCL_TIMEOUT, 0);
+}
+
+/*
+    Write uwWriteSize bytes, then read uwReadSize bytes from the device. Either part may be empty.
+
+    BSC interrupts are not routed to the m68k side, so the controller is polled. Every transfer has
+    a hard deadline, a device which does not answer or holds the clock low cannot block the caller.
+
+    If the write part fits into the FIFO, the read is started while the write is still active. The
+    controller then issues a repeated start instead of stop between both parts, which is what register
+    reads of most devices expect.
+*/
+ULONG TransferI2C(
+    UBYTE ubAddress,
+    UWORD uwWriteSize,
+    const UBYTE pWrite[],
+    UWORD uwReadSize,
+    UBYTE pRead[],
+    volatile tI2cRegs *pI2c
+)
+{
+    UBYTE isRead = uwReadSize != 0;
+
+    // bcm expects read/write bit to be omitted from address
+    ubAddress >>= 1;
+
+    if(rd32le(&pI2c->S) & I2C_S_TA) {
+        return RESULT(0, I2C_HARDW_BUSY, 0);
+    }
+
+    ULONG start = systimer_read();
+    ULONG timeout = I2C_TIMEOUT(uwWriteSize + uwReadSize);
+
+    wr32le(&pI2c->A, ubAddress);
+    wr32le(&pI2c->C, I2C_C_CLEAR_FIFO_ONE_SHOT);
+    wr32le(&pI2c->S, I2C_S_CLKT | I2C_S_ERR | I2C_S_DONE);
+
+    if(uwWriteSize && uwReadSize && uwWriteSize <= I2C_FIFO_SIZE) {
+        wr32le(&pI2c->DLEN, uwWriteSize);
+        while(uwWriteSize) {
+            wr32le(&pI2c->FIFO, *(pWrite++));
+            --uwWriteSize;
+        }
+        wr32le(&pI2c->C, I2C_C_I2CEN | I2C_C_ST | I2C_C_WRITE_PACKET);
+
+        while(!(rd32le(&pI2c->S) & (I2C_S_TA | I2C_S_DONE))) {
+            if(systimer_read() - start > timeout) {
+                return i2c_abort(pI2c);
+            }
+        }
+    }
+    else if(uwWriteSize) {
+        wr32le(&pI2c->DLEN, uwWriteSize);
+        wr32le(&pI2c->C, I2C_C_I2CEN | I2C_C_ST | I2C_C_WRITE_PACKET);
+
+        while(!(rd32le(&pI2c->S) & I2C_S_DONE)) {
+            while(uwWriteSize && (rd32le(&pI2c->S) & I2C_S_TXW)) {
+                wr32le(&pI2c->FIFO, *(pWrite++));
+                --uwWriteSize;
+            }
+            if(systimer_read() - start > timeout) {
+                return i2c_abort(pI2c);
+            }
+        }
+
+        if(uwReadSize) {
+            if((rd32le(&pI2c->S) & (I2C_S_ERR | I2C_S_CLKT)) || uwWriteSize) {
+                wr32le(&pI2c->S, I2C_S_CLKT | I2C_S_ERR | I2C_S_DONE);
+                return RESULT(0, I2C_NO_REPLY, 0);
+            }
+            wr32le(&pI2c->S, I2C_S_DONE);
+        }
+    }
+
+    if(uwReadSize) {
+        wr32le(&pI2c->DLEN, uwReadSize);
+        wr32le(&pI2c->C, I2C_C_I2CEN | I2C_C_ST | I2C_C_READ_PACKET);
+
+        do {
+            while(uwReadSize && (rd32le(&pI2c->S) & I2C_S_RXD)) {
+                *(pRead++) = rd32le(&pI2c->FIFO);
+                --uwReadSize;
+            }
+            if(systimer_read() - start > timeout) {
+                return i2c_abort(pI2c);
+            }
+        } while(!(rd32le(&pI2c->S) & I2C_S_DONE));
+
+        // Bytes received after the last check above
+        while(uwReadSize && (rd32le(&pI2c->S) & I2C_S_RXD)) {
+            *(pRead++) = rd32le(&pI2c->FIFO);
+            --uwReadSize;
+        }
+    }
+
+    ULONG ulStatus = rd32le(&pI2c->S);
+    wr32le(&pI2c->S, I2C_S_CLKT | I2C_S_ERR | I2C_S_DONE);
+
+    if((ulStatus & (I2C_S_ERR | I2C_S_CLKT)) || uwWriteSize || uwReadSize) {
+        return RESULT(0, isRead ? I2C_NO_REPLY : I2C_REJECT, 0);
+    }
+
+    return RESULT(1, I2C_OK, 0);
+}
+
+ULONG SendI2C(UBYTE ubAddress, UWORD uwDataSize, UBYTE pData[], volatile tI2cRegs *pI2c)
+{
+    return TransferI2C(ubAddress, uwDataSize, pData, 0, NULL, pI2c);
+}
+
+ULONG ReceiveI2C(UBYTE ubAddress, UWORD uwDataSize, UBYTE pData[], volatile tI2cRegs *pI2c)
+{
+    return TransferI2C(ubAddress, 0, NULL, uwDataSize, pData, pI2c);
+}
@@ -0,0 +1,86 @@
+#ifndef _I2C_H
+#define _I2C_H
+
+#include <exec/types.h>
+
+#define I2C_C_I2CEN (1 << 15) // I2C Enable
+#define I2C_C_INTR (1 <<  10) // Interrupt on RX
+#define I2C_C_INTT (1 << 9) // Interrupt on TX
+#define I2C_C_INTD (1 << 8) // Interrupt on Done
+#define I2C_C_ST (1 << 7) // Start transfer
+#define I2C_C_CLEAR_FIFO_NONE (0b00 << 4)
+#define I2C_C_CLEAR_FIFO_ONE_SHOT (0b01 << 4)
+#define I2C_C_CLEAR_FIFO_ONE_SHOT2 (0b10 << 4)
+#define I2C_C_WRITE_PACKET (0 << 0)
+#define I2C_C_READ_PACKET (1 << 0)
+
+#define I2C_S_CLKT (1 << 9) // Clock stretch timeout
+#define I2C_S_ERR (1 << 8) // ERR Ack error
+#define I2C_S_RXF (1 << 7) // RX FIFO full
+#define I2C_S_TXE (1 << 6) // TX FIFO empty
+#define I2C_S_RXD (1 << 5) // RX contains data
+#define I2C_S_TXD (1 << 4) // TX contains data
+#define I2C_S_RXR (1 << 3) // RX needs reading
+#define I2C_S_TXW (1 << 2) // TX needs writing
+#define I2C_S_DONE (1 << 1) // Transfer done
+#define I2C_S_TA (1 << 0) // Transfer active
+
+#define I2C_FIFO_SIZE 16
+
+typedef struct tI2cRegs {
+    ULONG C;
+    ULONG S;
+    ULONG DLEN;
+    ULONG A;
+    ULONG FIFO;
+    ULONG DIV;
+    ULONG DEL;
+    ULONG CLKT;
+} tI2cRegs;
+
+#define I2C_SPEED 400000
+
+/*
+    Transfers are abandoned if they take longer than the time needed to move all bytes at 100kHz
+    (9 clocks per byte) twice over, plus a fixed margin for clock stretching and start/stop
+*/
+#define I2C_TIMEOUT(bytes) (2000 + (bytes) * 180)
+
+#define RESULT(isSuccess, ubIoError, ubAllocError) (((ubAllocError) << 16) | ((ubIoError) << 8) | (isSuccess))
+
+
+// Allocation Errors
+// (as returned by AllocI2C, BringBackI2C, or found in the middle high
+// byte of the error codes from V39's SendI2C/ReceiveI2C)
+enum {
+    I2C_OK=0, // Hardware allocated successfully
+    I2C_PORT_BUSY, // \_Allocation is actually done in two steps:
+    I2C_BITS_BUSY, // / port & bits, and each step may fail
+    I2C_NO_MISC_RESOURCE, // Shouldn't occur, something's very wrong
+    I2C_ERROR_PORT, // Failed to create a message port
+    I2C_ACTIVE, // Some other I2C client has pushed us out
+    I2C_NO_TIMER // Failed to open the timer.device
+};
+
+// I/O Errors
+// (as found in the middle low byte of the error codes from V39's
+// SendI2C/ReceiveI2C)
+enum {
+    // I2C_OK=0, // Last send/receive was OK
+    I2C_REJECT=1, // Data not acknowledged (i.e. unwanted) */
+    I2C_NO_REPLY, // Chip address apparently invalid */
+    SDA_TRASHED, // SDA line randomly trashed. Timing problem? */
+    SDA_LO, // SDA always LO \_wrong interface attached, */
+    SDA_HI, // SDA always HI / or none at all? */
+    SCL_TIMEOUT, // \_Might make sense for interfaces that can */
+    SCL_HI,      // / read the clock line, but currently none can. */
+    I2C_HARDW_BUSY // Hardware allocation failed
+};
+
+void i2c_set_speed(volatile tI2cRegs *pI2c, ULONG core_clock);
+ULONG TransferI2C(UBYTE ubAddress, UWORD uwWriteSize, const UBYTE pWrite[], UWORD uwReadSize, UBYTE pRead[],
+    volatile tI2cRegs *pI2c);
+ULONG SendI2C(UBYTE ubAddress, UWORD uwDataSize, UBYTE pData[], volatile tI2cRegs *pI2c);
+ULONG ReceiveI2C(UBYTE ubAddress, UWORD uwDataSize, UBYTE pData[], volatile tI2cRegs *pI2c);
+
+#endif /* _I2C_H */
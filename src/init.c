@@ -18,7 +18,6 @@
 #include <inline/unicam.h>
 
 #include "unicam.h"
-#include "smoothing.h"
 #include "mbox.h"
 #include "videocore.h"
 #include "rga_host.h"
@@ -27,8 +26,6 @@ extern const char deviceName[];
 extern const char deviceIdString[];
 
 CONST_APTR GetPropValueRecursive(APTR key, CONST_STRPTR property, APTR DeviceTreeBase);
-CONST_STRPTR FindToken(CONST_STRPTR string, CONST_STRPTR token);
-int _strcmp(const char *s1, const char *s2);
 
 APTR Init(REGARG(struct ExecBase *SysBase, "a6"))
 {
@@ -77,9 +74,24 @@ APTR Init(REGARG(struct ExecBase *SysBase, "a6"))
             relFuncTable[14] = (ULONG)&L_UnicamSetKernel;
             relFuncTable[15] = (ULONG)&L_UnicamGetAspect;
             relFuncTable[16] = (ULONG)&L_UnicamSetAspect;
-            relFuncTable[17] = (ULONG)-1;
+            relFuncTable[17] = (ULONG)&L_UnicamSetBuffers;
+            relFuncTable[18] = (ULONG)&L_UnicamGetBuffers;
+            relFuncTable[19] = (ULONG)&L_UnicamWaitFrame;
+            relFuncTable[20] = (ULONG)&L_UnicamGetFrameSequence;
+            relFuncTable[21] = (ULONG)&L_UnicamGetStats;
+            relFuncTable[22] = (ULONG)&L_UnicamGetErrors;
+            relFuncTable[23] = (ULONG)&L_UnicamGetGeneration;
+            relFuncTable[24] = (ULONG)&L_UnicamSetFilter;
+            relFuncTable[25] = (ULONG)&L_UnicamGetFilter;
+            relFuncTable[26] = (ULONG)&L_UnicamGetStride;
+            relFuncTable[27] = (ULONG)&L_UnicamGrabFrame;
+            relFuncTable[28] = (ULONG)&L_UnicamGrabPlanar;
+            relFuncTable[29] = (ULONG)&L_UnicamRegisterDL;
+            relFuncTable[30] = (ULONG)&L_UnicamUnregisterDL;
+            relFuncTable[31] = (ULONG)-1;
 
             UnicamBase = (struct UnicamBase *)((UBYTE *)base_pointer + BASE_NEG_SIZE);
+            BOOT_MARK(UnicamBase, BOOT_START);
             UnicamBase->u_SysBase = SysBase;
             UnicamBase->u_MailboxBase = MailboxBase;
 
@@ -111,6 +123,12 @@ APTR Init(REGARG(struct ExecBase *SysBase, "a6"))
             UnicamBase->u_KernelB = 250;
             UnicamBase->u_KernelC = 750;
             UnicamBase->u_Aspect = 1000;
+            UnicamBase->u_BufferCount = 1;
+            UnicamBase->u_Lanes = 1;
+            UnicamBase->u_Generation = 1;
+
+            InitSemaphore(&UnicamBase->u_Lock);
+            unicam_init_interrupt(UnicamBase);
 
             SumLibrary((struct Library*)UnicamBase);
 
@@ -126,9 +144,6 @@ APTR Init(REGARG(struct ExecBase *SysBase, "a6"))
                 return NULL;
             }
 
-            const char *cmdline = DT_GetPropValue(DT_FindProperty(DT_OpenKey("/chosen"), "bootargs"));
-            const char *cmd;
-
             if (_strcmp(DT_GetPropValue(DT_FindProperty(key, "status")), "okay") == 0)
             {
                 start_on_boot = 1;
@@ -142,6 +157,12 @@ APTR Init(REGARG(struct ExecBase *SysBase, "a6"))
                 bug("[unicam] Use integer scaling\n");
             }
 
+            if (DT_FindProperty(key, "capture-window"))
+            {
+                UnicamBase->u_Window = TRUE;
+                bug("[unicam] Capture cropped window only\n");
+            }
+
             ULONG kernel = *(ULONG *)DT_GetPropValue(DT_FindProperty(key, "kernel"));
             UnicamBase->u_KernelB = kernel >> 16;
             UnicamBase->u_KernelC = kernel & 0xffff;
@@ -156,6 +177,14 @@ APTR Init(REGARG(struct ExecBase *SysBase, "a6"))
                 bug("[unicam] Enable smoothing kernel. B=%ld, C=%ld\n", UnicamBase->u_KernelB, UnicamBase->u_KernelC);
             }
 
+            const ULONG *filter = DT_GetPropValue(DT_FindProperty(key, "filter"));
+            if (filter != NULL)
+            {
+                UnicamBase->u_FilterH = *filter >> 16;
+                UnicamBase->u_FilterV = *filter & 0xffff;
+                bug("[unicam] Scaling filter H=%ld, V=%ld\n", UnicamBase->u_FilterH, UnicamBase->u_FilterV);
+            }
+
             ULONG scaler = *(ULONG *)DT_GetPropValue(DT_FindProperty(key, "scaler"));
             UnicamBase->u_Scaler = scaler >> 16;
             UnicamBase->u_Phase = scaler & 0xffff;
@@ -179,6 +208,60 @@ APTR Init(REGARG(struct ExecBase *SysBase, "a6"))
             UnicamBase->u_Type = *(ULONG *)DT_GetPropValue(DT_FindProperty(key, "type"));
             UnicamBase->u_PixelOrder = *(ULONG *)DT_GetPropValue(DT_FindProperty(key, "pixel-order"));
 
+            const ULONG *lanes = DT_GetPropValue(DT_FindProperty(key, "lanes"));
+            if (lanes != NULL && *lanes >= 1 && *lanes <= UNICAM_MAX_LANES)
+            {
+                UnicamBase->u_Lanes = *lanes;
+                bug("[unicam] CSI-2 lanes: %ld\n", UnicamBase->u_Lanes);
+            }
+
+            /* Line padding, power of two up to 256 bytes */
+            const ULONG *stride_align = DT_GetPropValue(DT_FindProperty(key, "stride-align"));
+            if (stride_align != NULL && *stride_align <= 256 && (*stride_align & (*stride_align - 1)) == 0)
+            {
+                UnicamBase->u_StrideAlign = *stride_align;
+                bug("[unicam] Line stride aligned to %ld bytes\n", UnicamBase->u_StrideAlign);
+            }
+
+            const ULONG *buffers = DT_GetPropValue(DT_FindProperty(key, "buffers"));
+            if (buffers != NULL && *buffers > 0)
+            {
+                UnicamBase->u_BufferCount = *buffers > UNICAM_MAX_BUFFERS ? UNICAM_MAX_BUFFERS : *buffers;
+                bug("[unicam] Capture buffers: %ld\n", UnicamBase->u_BufferCount);
+            }
+
+            /* EDID profile offered by the HDMI bridge, capture format follows it */
+            const char *edid = DT_GetPropValue(DT_FindProperty(key, "edid"));
+            if (edid != NULL && UnicamBase->u_Type == TYPE_C790)
+            {
+                if (c790_select_edid(UnicamBase, edid))
+                    bug("[unicam] EDID profile: %s\n", (ULONG)edid);
+                else
+                    bug("[unicam] Unknown EDID profile: %s\n", (ULONG)edid);
+            }
+
+            /* YUV 4:2:2 capture, a third less data on the link, in memory and through the HVS than RGB888 */
+            const char *format = DT_GetPropValue(DT_FindProperty(key, "format"));
+            if (format != NULL && _strcmp(format, "yuv422") == 0)
+            {
+                UnicamBase->u_Mode = CSI_DT_YUV422_8;
+                UnicamBase->u_BPP = 16;
+                bug("[unicam] Capture format: YUV422\n");
+            }
+
+            /*
+                Capture sizes for NTSC, NTSC laced, PAL and PAL laced input, used by the mode monitor.
+                Modes missing in a shorter property keep the full size.
+            */
+            APTR mode_prop = DT_FindProperty(key, "mode-sizes");
+            const ULONG *mode_sizes = DT_GetPropValue(mode_prop);
+            ULONG mode_count = mode_sizes != NULL ? DT_GetPropLen(mode_prop) / 4 : 0;
+            for (ULONG i=0; i < 4; i++)
+                UnicamBase->u_ModeSize[i] = i < mode_count ? mode_sizes[i] :
+                    (UnicamBase->u_FullSize.width << 16) | UnicamBase->u_FullSize.height;
+
+            int auto_mode = DT_FindProperty(key, "auto-mode") != NULL;
+
             bug("[unicam] Displayed size: %ld x %ld\n", UnicamBase->u_Size.width, UnicamBase->u_Size.height);
             bug("[unicam] Display offset: %ld, %ld\n", UnicamBase->u_Offset.x, UnicamBase->u_Offset.y);
             bug("[unicam] Type: %s\n", (ULONG)(UnicamBase->u_Type == 0 ? "FrameThrower" : "C790"));
@@ -249,28 +332,25 @@ APTR Init(REGARG(struct ExecBase *SysBase, "a6"))
 
             if (UnicamBase->u_ReceiveBuffer == NULL)
             {
-                const ULONG size = sizeof(ULONG) * UnicamBase->u_FullSize.width * UnicamBase->u_FullSize.height + 512;
-                
-                UnicamBase->u_ReceiveBuffer = AllocMem(size, MEMF_FAST);
-                UnicamBase->u_ReceiveBufferSize = size;
-
-                UnicamBase->u_ReceiveBuffer = (APTR)(((ULONG)UnicamBase->u_ReceiveBuffer + 63) & ~63);
+                unicam_alloc_receive(UnicamBase, UnicamBase->u_FullSize.width, UnicamBase->u_FullSize.height,
+                    UnicamBase->u_BPP, UnicamBase->u_BufferCount);
             }
 
             bug("[unicam] Receive buffer: %08lx, size: %08lx\n", (ULONG)UnicamBase->u_ReceiveBuffer, UnicamBase->u_ReceiveBufferSize);
 
+            BOOT_MARK(UnicamBase, BOOT_DT);
+
             while (UnicamBase->u_DisplaySize.width == 0 || UnicamBase->u_DisplaySize.height == 0)
             {
                 UnicamBase->u_DisplaySize = get_display_size(UnicamBase);
             }
 
+            BOOT_MARK(UnicamBase, BOOT_MAILBOX);
+
             AddResource(UnicamBase);
 
             if (start_on_boot)
             {
-                LONG kernel_b = (UnicamBase->u_KernelB * 256) / 1000;
-                LONG kernel_c = (UnicamBase->u_KernelC * 256) / 1000;
-
                 UnicamBase->u_UnicamKernel = 0xfc0;
                 ULONG *dlistPtr = (ULONG *)((ULONG)UnicamBase->u_PeriphBase + 
                     (UnicamBase->u_IsVC6 ? 0x00404000 : 0x00402000));
@@ -285,30 +365,29 @@ APTR Init(REGARG(struct ExecBase *SysBase, "a6"))
                     rga_set_scanlines(scanl, lscanl);
                 }
 
-                UnicamStart(UnicamBase->u_ReceiveBuffer, 1, 
+                BOOT_MARK(UnicamBase, BOOT_CHIP);
+
+                UnicamStart(UnicamBase->u_ReceiveBuffer, UnicamBase->u_Lanes, 
                     UnicamBase->u_Mode, 
                     UnicamBase->u_FullSize.width, UnicamBase->u_FullSize.height,
                     UnicamBase->u_BPP);
 
-                if (UnicamBase->u_Smooth)
-                {
-                    compute_scaling_kernel(&dlistPtr[UnicamBase->u_UnicamKernel], kernel_b, kernel_c);
-                }
-                else
-                {
-                    compute_nearest_neighbour_kernel(&dlistPtr[UnicamBase->u_UnicamKernel]);
-                }
+                BOOT_MARK(UnicamBase, BOOT_UNICAM);
 
-                if (UnicamBase->u_IsVC6)
-                {
-                    VC6_ConstructUnicamDL(UnicamBase, UnicamBase->u_UnicamKernel);
-                }
-                else
-                {
-                    VC4_ConstructUnicamDL(UnicamBase, UnicamBase->u_UnicamKernel);
-                }
+                unicam_write_kernel(UnicamBase, &dlistPtr[UnicamBase->u_UnicamKernel]);
+                ConstructUnicamDL(UnicamBase, UnicamBase->u_UnicamKernel);
+
+                wr32le((volatile ULONG *)(UnicamBase->u_PeriphBase + 0x00400024), UnicamBase->u_UnicamDL);
+
+                BOOT_MARK(UnicamBase, BOOT_DL);
+            }
 
-                *(volatile uint32_t *)(UnicamBase->u_PeriphBase + 0x00400024) = LE32(UnicamBase->u_UnicamDL);
+            boot_profile_report(UnicamBase);
+
+            if (auto_mode)
+            {
+                bug("[unicam] Starting input mode monitor\n");
+                unicam_start_monitor(UnicamBase);
             }
 
             binding.cb_ConfigDev->cd_Flags &= ~CDF_CONFIGME;
@@ -356,58 +435,3 @@ CONST_APTR GetPropValueRecursive(APTR key, CONST_STRPTR property, APTR DeviceTre
 
     return NULL;
 }
-
-
-CONST_STRPTR FindToken(CONST_STRPTR string, CONST_STRPTR token)
-{
-    CONST_STRPTR ret = NULL;
-
-    if (string)
-    {
-        do {
-            while (*string == ' ' || *string == '\t') {
-                string++;
-            }
-
-            if (*string == 0)
-                break;
-
-            for (int i=0; token[i] != 0; i++)
-            {
-                if (string[i] != token[i])
-                {
-                    break;
-                }
-
-                if (token[i] == '=') {
-                    ret = string;
-                    break;
-                }
-
-                if (string[i+1] == 0 || string[i+1] == ' ' || string[i+1] == '\t') {
-                    ret = string;
-                    break;
-                }
-            }
-
-            if (ret)
-                break;
-
-            while(*string != 0) {
-                if (*string != ' ' && *string != '\t')
-                    string++;
-                else break;
-            }
-
-        } while(!ret && *string != 0);
-    }
-    return ret;
-}
-
-int _strcmp(const char *s1, const char *s2)
-{
-    while (*s1 == *s2++)
-        if (*s1++ == '\0')
-            return (0);
-    return (*(const unsigned char *)s1 - *(const unsigned char *)(s2 - 1));
-}
@@ -0,0 +1,315 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+#include <exec/interrupts.h>
+#include <hardware/intbits.h>
+#include <common/compiler.h>
+
+#include <proto/exec.h>
+
+#include "unicam.h"
+#include "vc4-regs-unicam.h"
+
+extern const char deviceName[];
+
+/* Signal all tasks sleeping in UnicamWaitFrame(). Has to be called with interrupts disabled */
+static void signal_waiters(struct UnicamBase * UnicamBase)
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+    struct FrameWaiter *waiter;
+
+    while ((waiter = (struct FrameWaiter *)UnicamBase->u_FrameWaiters.mlh_Head)->fw_Node.mln_Succ != NULL)
+    {
+        Remove((struct Node *)waiter);
+        Signal(waiter->fw_Task, 1UL << waiter->fw_Signal);
+    }
+}
+
+/*
+    Wake up tasks for which no frame ended within WAIT_FRAMES frame periods, the source is gone or
+    the capture stalled. Has to be called with interrupts disabled
+*/
+static void expire_waiters(struct UnicamBase * UnicamBase, ULONG now)
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+    ULONG timeout = UnicamBase->u_FramePeriod ? UnicamBase->u_FramePeriod * WAIT_FRAMES : WAIT_PERIOD;
+    struct FrameWaiter *waiter;
+    struct FrameWaiter *next;
+
+    for (waiter = (struct FrameWaiter *)UnicamBase->u_FrameWaiters.mlh_Head;
+         (next = (struct FrameWaiter *)waiter->fw_Node.mln_Succ) != NULL; waiter = next)
+    {
+        if (now - waiter->fw_Start >= timeout)
+        {
+            Remove((struct Node *)waiter);
+            waiter->fw_TimedOut = TRUE;
+            Signal(waiter->fw_Task, 1UL << waiter->fw_Signal);
+        }
+    }
+}
+
+#define STA_ERRORS (UNICAM_CRCE | UNICAM_SBE | UNICAM_PBE | UNICAM_HOE | UNICAM_PLE | \
+                    UNICAM_IFO | UNICAM_OFO | UNICAM_BFO)
+
+static inline void count_error(ULONG *counter)
+{
+    if (*counter != 0xffffffff)
+        (*counter)++;
+}
+
+/* Accumulate receiver errors latched in UNICAM_STA since the last poll and clear them */
+static void check_errors(struct UnicamBase * UnicamBase)
+{
+    ULONG sta = ReadReg(UnicamBase, UNICAM_STA) & STA_ERRORS;
+
+    if (sta == 0)
+        return;
+
+    if (sta & UNICAM_CRCE) count_error(&UnicamBase->u_Errors.ue_CRC);
+    if (sta & UNICAM_SBE) count_error(&UnicamBase->u_Errors.ue_SOT);
+    if (sta & UNICAM_PBE) count_error(&UnicamBase->u_Errors.ue_Packet);
+    if (sta & UNICAM_HOE) count_error(&UnicamBase->u_Errors.ue_Header);
+    if (sta & UNICAM_PLE) count_error(&UnicamBase->u_Errors.ue_Length);
+    if (sta & UNICAM_IFO) count_error(&UnicamBase->u_Errors.ue_ImageOverflow);
+    if (sta & UNICAM_OFO) count_error(&UnicamBase->u_Errors.ue_OutputOverflow);
+    if (sta & UNICAM_BFO) count_error(&UnicamBase->u_Errors.ue_BufferOverflow);
+
+    WriteReg(UnicamBase, UNICAM_STA, sta);
+}
+
+/* Hardware has latched the queued buffer and captures into it */
+static void frame_start(struct UnicamBase * UnicamBase)
+{
+    UnicamBase->u_InFrame = TRUE;
+    UnicamBase->u_WriteBuffer = UnicamBase->u_QueuedBuffer;
+}
+
+/*
+    Queue the buffer for the frame after the one in progress. Image pointers are latched at frame
+    start, so they are written only between a frame start and its frame end. After the frame end the
+    next start may not have latched the queued buffer yet and new pointers would replace it. With two
+    buffers the one on screen is queued, it leaves the screen at the end of the frame in progress.
+*/
+static void queue_next(struct UnicamBase * UnicamBase)
+{
+    UBYTE count = UnicamBase->u_ActiveBuffers;
+    UBYTE write = UnicamBase->u_WriteBuffer;
+
+    if (count < 2 || UnicamBase->u_QueuedBuffer != write)
+        return;
+
+    /* Frame has ended since ISTA was read */
+    if (ReadReg(UnicamBase, UNICAM_ISTA) & UNICAM_FEI)
+        return;
+
+    unicam_set_buffer(UnicamBase, write + 1 < count ? write + 1 : 0);
+}
+
+/*
+    Called from the vertical blank server, so now is the time of the poll and not of the frame end
+    itself. Frame start is not timed at all, it is usually seen by the same poll.
+*/
+static void frame_end(struct UnicamBase * UnicamBase, ULONG now)
+{
+    UnicamBase->u_InFrame = FALSE;
+    /* UNICAM_WAIT_TIMEOUT is never a sequence number */
+    if (++UnicamBase->u_FrameSequence == UNICAM_WAIT_TIMEOUT)
+        UnicamBase->u_FrameSequence = 0;
+    framestats_end(&UnicamBase->u_FrameStats, now);
+
+    if (UnicamBase->u_Recovering)
+    {
+        ULONG time = now - UnicamBase->u_LastFrameEnd;
+
+        UnicamBase->u_Errors.ue_RecoveryLast = time;
+        if (time > UnicamBase->u_Errors.ue_RecoveryMax)
+            UnicamBase->u_Errors.ue_RecoveryMax = time;
+
+        UnicamBase->u_Recovering = FALSE;
+        UnicamBase->u_StallRetries = 0;
+    }
+    else if (UnicamBase->u_WatchdogArmed)
+    {
+        UnicamBase->u_FramePeriod = now - UnicamBase->u_LastFrameEnd;
+    }
+
+    UnicamBase->u_WatchdogArmed = TRUE;
+    UnicamBase->u_LastFrameEnd = now;
+    UnicamBase->u_LastProgress = now;
+
+    /*
+        Completed frame goes to the screen. If no other buffer was queued while it was captured, the
+        next frame goes to the same buffer and the previous one stays on screen.
+    */
+    if (UnicamBase->u_ActiveBuffers > 1 && UnicamBase->u_QueuedBuffer != UnicamBase->u_WriteBuffer)
+    {
+        UnicamBase->u_DisplayBuffer = UnicamBase->u_WriteBuffer;
+        unicam_update_address(UnicamBase);
+    }
+
+    signal_waiters(UnicamBase);
+}
+
+/*
+    Capture is considered stalled when neither the write pointer moved nor a frame ended for a few
+    frame periods. The watchdog is armed by the first frame after capture was started, so a source
+    which is not connected at all does not cause restarts. Each unsuccessful restart doubles the
+    timeout.
+*/
+static void watchdog(struct UnicamBase * UnicamBase, ULONG now)
+{
+    ULONG ibwp = ReadReg(UnicamBase, UNICAM_IBWP);
+
+    if (ibwp != UnicamBase->u_LastIBWP)
+    {
+        UnicamBase->u_LastIBWP = ibwp;
+        UnicamBase->u_LastProgress = now;
+        return;
+    }
+
+    ULONG timeout = UnicamBase->u_FramePeriod ? UnicamBase->u_FramePeriod * WATCHDOG_FRAMES : WATCHDOG_PERIOD;
+    timeout <<= UnicamBase->u_StallRetries;
+
+    if (now - UnicamBase->u_LastProgress < timeout)
+        return;
+
+    if (!UnicamBase->u_Recovering)
+        count_error(&UnicamBase->u_Errors.ue_Stalls);
+
+    if (UnicamBase->u_StallRetries < WATCHDOG_BACKOFF)
+        UnicamBase->u_StallRetries++;
+
+    UnicamBase->u_Recovering = TRUE;
+    unicam_restart(UnicamBase);
+
+    UnicamBase->u_LastIBWP = ReadReg(UnicamBase, UNICAM_IBWP);
+    UnicamBase->u_LastProgress = now;
+}
+
+/*
+    With both frame events pending, the poll sees either the end of a frame and the start of the next
+    one, or a whole frame. The write pointer tells them apart: it is still short of the last line of
+    the buffer latched at frame start while the frame is in progress.
+*/
+static BOOL frame_in_progress(struct UnicamBase * UnicamBase)
+{
+    struct Point offset;
+    struct Size size;
+    ULONG start = (ULONG)UnicamBase->u_Buffers[UnicamBase->u_QueuedBuffer] & ~0xC0000000;
+    ULONG ibwp = ReadReg(UnicamBase, UNICAM_IBWP) & ~0xC0000000;
+
+    unicam_get_window(UnicamBase, &offset, &size);
+
+    return ibwp - start < (size.height - 1) * unicam_stride(UnicamBase);
+}
+
+/*
+    Frame events of Unicam are not routed to the m68k side. They are latched in UNICAM_ISTA though,
+    so a vertical blank server picks them up once per frame, rotates the capture buffers and wakes
+    up tasks waiting for a new frame.
+*/
+static ULONG UnicamVBlankServer(REGARG(struct UnicamBase * UnicamBase, "a1"))
+{
+    ULONG ista = ReadReg(UnicamBase, UNICAM_ISTA);
+    ULONG now = systimer_read();
+
+    /*
+        If both events are pending and a frame is in progress now, the frame end belongs to the
+        previous one and the start opens the current one.
+    */
+    if ((ista & (UNICAM_FSI | UNICAM_FEI)) == (UNICAM_FSI | UNICAM_FEI) && frame_in_progress(UnicamBase))
+    {
+        frame_end(UnicamBase, now);
+        frame_start(UnicamBase);
+    }
+    else
+    {
+        if (ista & UNICAM_FSI)
+            frame_start(UnicamBase);
+        if (ista & UNICAM_FEI)
+            frame_end(UnicamBase, now);
+    }
+
+    /* Crop rectangle changed while Unicam captures it only */
+    if (UnicamBase->u_WindowPending)
+        unicam_set_window(UnicamBase);
+
+    /* Crop offset changed since last poll and no buffer flip has picked it up */
+    if (UnicamBase->u_OffsetPending)
+        unicam_update_address(UnicamBase);
+
+    if (ista)
+        WriteReg(UnicamBase, UNICAM_ISTA, ista);
+
+    if (UnicamBase->u_InFrame)
+        queue_next(UnicamBase);
+
+    check_errors(UnicamBase);
+
+    if (UnicamBase->u_Running && UnicamBase->u_WatchdogArmed)
+        watchdog(UnicamBase, now);
+
+    expire_waiters(UnicamBase, now);
+
+    /* Wake up the input mode monitor */
+    if (UnicamBase->u_MonitorTask && ++UnicamBase->u_MonitorTick >= MONITOR_INTERVAL)
+    {
+        struct ExecBase *SysBase = UnicamBase->u_SysBase;
+
+        UnicamBase->u_MonitorTick = 0;
+        Signal(UnicamBase->u_MonitorTask, 1UL << UnicamBase->u_MonitorSignal);
+    }
+
+    return 0;
+}
+
+void unicam_init_interrupt(struct UnicamBase * UnicamBase)
+{
+    UnicamBase->u_VBlankInt.is_Node.ln_Type = NT_INTERRUPT;
+    UnicamBase->u_VBlankInt.is_Node.ln_Pri = -10;
+    UnicamBase->u_VBlankInt.is_Node.ln_Name = (STRPTR)deviceName;
+    UnicamBase->u_VBlankInt.is_Data = UnicamBase;
+    UnicamBase->u_VBlankInt.is_Code = (void (*)())UnicamVBlankServer;
+
+    UnicamBase->u_FrameWaiters.mlh_Head = (struct MinNode *)&UnicamBase->u_FrameWaiters.mlh_Tail;
+    UnicamBase->u_FrameWaiters.mlh_Tail = NULL;
+    UnicamBase->u_FrameWaiters.mlh_TailPred = (struct MinNode *)&UnicamBase->u_FrameWaiters.mlh_Head;
+}
+
+void unicam_add_interrupt(struct UnicamBase * UnicamBase)
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+
+    if (!UnicamBase->u_IntInstalled)
+    {
+        AddIntServer(INTB_VERTB, &UnicamBase->u_VBlankInt);
+        UnicamBase->u_IntInstalled = TRUE;
+    }
+}
+
+void unicam_wake_waiters(struct UnicamBase * UnicamBase)
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+
+    Disable();
+    signal_waiters(UnicamBase);
+    Enable();
+}
+
+void unicam_rem_interrupt(struct UnicamBase * UnicamBase)
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+
+    if (UnicamBase->u_IntInstalled)
+    {
+        RemIntServer(INTB_VERTB, &UnicamBase->u_VBlankInt);
+        UnicamBase->u_IntInstalled = FALSE;
+    }
+}
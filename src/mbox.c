@@ -54,6 +54,26 @@ ULONG enable_unicam_domain(struct UnicamBase *UnicamBase)
     return FBReq[6];
 }
 
+/* Rate of given VideoCore clock in Hz, 0 if the firmware does not know it */
+ULONG get_clock_rate(struct UnicamBase *UnicamBase, ULONG clock)
+{
+    ULONG FBReq[8];
+    APTR MailboxBase = UnicamBase->u_MailboxBase;
+
+    FBReq[0] = 4 * 8;
+    FBReq[1] = 0;
+    FBReq[2] = VCTAG_GET_CLOCK_RATE;
+    FBReq[3] = 8;
+    FBReq[4] = 0;
+    FBReq[5] = clock;
+    FBReq[6] = 0;
+    FBReq[7] = 0;
+
+    MB_RawCommand(FBReq);
+
+    return FBReq[6];
+}
+
 struct Size get_display_size(struct UnicamBase *UnicamBase)
 {
     ULONG FBReq[8];
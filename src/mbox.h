@@ -4,7 +4,10 @@
 #include "unicam.h"
 #include <stdint.h>
 
+#define CLOCK_CORE  4
+
 ULONG enable_unicam_domain(struct UnicamBase *UnicamBase);
 struct Size get_display_size(struct UnicamBase *UnicamBase);
+ULONG get_clock_rate(struct UnicamBase *UnicamBase, ULONG clock);
 
 #endif /* _MBOX_H */
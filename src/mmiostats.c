@@ -0,0 +1,26 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+
+#include "unicam.h"
+
+#ifdef UNICAM_MMIO_STATS
+
+/*
+    Print MMIO accesses counted since MMIO_BEGIN. Accesses of the vertical blank server running in
+    the meantime are included, so expect a few extra reads while capture is active.
+*/
+void mmio_report(struct UnicamBase * UnicamBase, CONST_STRPTR call)
+{
+    bug("[unicam] %s: %ld MMIO reads, %ld MMIO writes\n", (ULONG)call,
+        UnicamBase->u_MmioReads, UnicamBase->u_MmioWrites);
+}
+
+#endif /* UNICAM_MMIO_STATS */
@@ -0,0 +1,209 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+#include <exec/tasks.h>
+#include <exec/memory.h>
+
+#include <proto/exec.h>
+
+#include "unicam.h"
+#include "videocore.h"
+#include "rga_host.h"
+
+extern const char deviceName[];
+
+/* Current input mode as (width << 16) | height, 0 if it cannot be determined */
+static ULONG get_input_mode(struct UnicamBase * UnicamBase)
+{
+    if (UnicamBase->u_Type == TYPE_C790)
+    {
+        return c790_get_mode();
+    }
+    else
+    {
+        RGA_VideoStatus status;
+
+        if (!rga_get_video_status(&status))
+            return 0;
+
+        return UnicamBase->u_ModeSize[(status.isPAL ? 2 : 0) + (status.laced ? 1 : 0)];
+    }
+}
+
+/*
+    Restart capture with the new frame size and, if the display list was built by us on boot, rebuild
+    it. The crop rectangle set by the user is kept as far as it fits into the new frame, its offset
+    is moved in first and its size is clamped then. The receive buffer grows if it was taken from
+    Fast RAM, the old one is retired and freed by the monitor once no display list refers to it.
+    Returns FALSE if the frame does not fit into the buffer, capture goes on in the old mode then.
+    Called with u_Lock held.
+*/
+static BOOL reconfigure(struct UnicamBase * UnicamBase, ULONG mode)
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+    ULONG width = mode >> 16;
+    ULONG height = mode & 0xffff;
+    ULONG slot = unicam_frame_slot(UnicamBase, width, height, UnicamBase->u_BPP);
+
+    if (slot > UnicamBase->u_ReceiveBufferSize && UnicamBase->u_ReceiveAlloc == NULL)
+    {
+        return FALSE;
+    }
+
+    unicam_stop(UnicamBase);
+
+    /* Not enough memory for all frames, but a single one may still fit into the old buffer */
+    if (!unicam_alloc_receive(UnicamBase, width, height, UnicamBase->u_BPP, UnicamBase->u_BufferCount) &&
+        !unicam_alloc_receive(UnicamBase, width, height, UnicamBase->u_BPP, 1))
+    {
+        unicam_run(UnicamBase->u_ReceiveBuffer, UnicamBase->u_Lanes, UnicamBase->u_Mode,
+            UnicamBase->u_FullSize.width, UnicamBase->u_FullSize.height, UnicamBase->u_BPP, UnicamBase);
+        return FALSE;
+    }
+
+    /* Link rate and transmitter timing of the bridge follow the new mode, the receiver takes them on start */
+    if (UnicamBase->u_Type == TYPE_C790 && !c790_update_timing(UnicamBase))
+        bug("[unicam] Cannot read timing of the new mode, CSI-2 link left unchanged\n");
+
+    Disable();
+    UnicamBase->u_FullSize.width = width;
+    UnicamBase->u_FullSize.height = height;
+    if (UnicamBase->u_Size.width > width)
+        UnicamBase->u_Size.width = width;
+    if (UnicamBase->u_Size.height > height)
+        UnicamBase->u_Size.height = height;
+    if (UnicamBase->u_Offset.x + UnicamBase->u_Size.width > width)
+        UnicamBase->u_Offset.x = width - UnicamBase->u_Size.width;
+    if (UnicamBase->u_Offset.y + UnicamBase->u_Size.height > height)
+        UnicamBase->u_Offset.y = height - UnicamBase->u_Size.height;
+    UnicamBase->u_Generation++;
+    Enable();
+
+    unicam_run(UnicamBase->u_ReceiveBuffer, UnicamBase->u_Lanes, UnicamBase->u_Mode,
+        width, height, UnicamBase->u_BPP, UnicamBase);
+
+    if (UnicamBase->u_UnicamDL != 0)
+    {
+        volatile ULONG *dlist = (ULONG *)((ULONG)UnicamBase->u_PeriphBase +
+            (UnicamBase->u_IsVC6 ? 0x00404000 : 0x00402000));
+
+        unicam_write_kernel(UnicamBase, &dlist[UnicamBase->u_UnicamKernel]);
+        ConstructUnicamDL(UnicamBase, UnicamBase->u_UnicamKernel);
+
+        wr32le((volatile ULONG *)(UnicamBase->u_PeriphBase + 0x00400024), UnicamBase->u_UnicamDL);
+    }
+    else
+    {
+        /* Plane registered by the application shows the new buffer, its geometry is up to the owner */
+        Disable();
+        unicam_update_address(UnicamBase);
+        Enable();
+    }
+
+    return TRUE;
+}
+
+/*
+    The monitor is woken up by the vertical blank server while capture is running. A new mode has to
+    be reported by two consecutive polls before capture is reconfigured, so that the transient state
+    during a mode switch of the source is ignored. Capture state is changed only with u_Lock held, the
+    same lock the public calls take.
+*/
+static void MonitorTask(void)
+{
+    struct ExecBase *SysBase = *(struct ExecBase **)4UL;
+    struct Task *me = FindTask(NULL);
+    struct UnicamBase *UnicamBase = me->tc_UserData;
+    ULONG current = (UnicamBase->u_FullSize.width << 16) | UnicamBase->u_FullSize.height;
+    ULONG candidate = 0;
+    ULONG detected = 0;
+
+    UnicamBase->u_MonitorSignal = AllocSignal(-1);
+    UnicamBase->u_MonitorTask = me;
+
+    for (;;)
+    {
+        Wait(1UL << UnicamBase->u_MonitorSignal);
+
+        ObtainSemaphore(&UnicamBase->u_Lock);
+        unicam_release_retired(UnicamBase);
+        ReleaseSemaphore(&UnicamBase->u_Lock);
+
+        /* Leave capture started by someone else into their own buffer alone */
+        if (!UnicamBase->u_Running || UnicamBase->u_CaptureAddress != UnicamBase->u_ReceiveBuffer)
+            continue;
+
+        ULONG mode = get_input_mode(UnicamBase);
+
+        if (mode == 0 || mode == current)
+        {
+            candidate = 0;
+            continue;
+        }
+
+        if (mode != candidate)
+        {
+            candidate = mode;
+            detected = systimer_read();
+            continue;
+        }
+
+        ObtainSemaphore(&UnicamBase->u_Lock);
+
+        /* Application may have stopped or moved capture while the mode was read, try again next poll */
+        if (UnicamBase->u_Running && UnicamBase->u_CaptureAddress == UnicamBase->u_ReceiveBuffer)
+        {
+            if (reconfigure(UnicamBase, mode))
+            {
+                bug("[unicam] Input mode %ld x %ld, reconfigured in %ld us\n", mode >> 16, mode & 0xffff,
+                    systimer_read() - detected);
+            }
+            else
+            {
+                bug("[unicam] Input mode %ld x %ld does not fit into receive buffer\n", mode >> 16, mode & 0xffff);
+            }
+
+            current = mode;
+            candidate = 0;
+        }
+
+        ReleaseSemaphore(&UnicamBase->u_Lock);
+    }
+}
+
+void unicam_start_monitor(struct UnicamBase * UnicamBase)
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+    struct Task *task = AllocMem(sizeof(struct Task), MEMF_PUBLIC | MEMF_CLEAR);
+    APTR stack = AllocMem(MONITOR_STACK, MEMF_PUBLIC | MEMF_CLEAR);
+
+    if (task == NULL || stack == NULL)
+    {
+        if (task)
+            FreeMem(task, sizeof(struct Task));
+        if (stack)
+            FreeMem(stack, MONITOR_STACK);
+        return;
+    }
+
+    task->tc_Node.ln_Type = NT_TASK;
+    task->tc_Node.ln_Pri = 5;
+    task->tc_Node.ln_Name = (STRPTR)deviceName;
+    task->tc_SPLower = stack;
+    task->tc_SPUpper = (UBYTE *)stack + MONITOR_STACK;
+    task->tc_SPReg = task->tc_SPUpper;
+    task->tc_UserData = UnicamBase;
+
+    task->tc_MemEntry.lh_Head = (struct Node *)&task->tc_MemEntry.lh_Tail;
+    task->tc_MemEntry.lh_Tail = NULL;
+    task->tc_MemEntry.lh_TailPred = (struct Node *)&task->tc_MemEntry.lh_Head;
+
+    AddTask(task, (APTR)MonitorTask, NULL);
+}
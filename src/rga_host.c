@@ -11,7 +11,7 @@
 #define DELAY_ADDR    ((volatile uint16_t*)0x00bfe001)
 #define RETRY_LIMIT   350000
 
-static uint16_t calc_crc(uint16_t* buf, int len) {
+static uint16_t calc_crc(const uint16_t* buf, int len) {
     uint16_t crc = 0;
     for(int i=0; i<len; i++) crc ^= buf[i];
     return crc;
@@ -26,8 +26,7 @@ void rga_flush_pipe(void) {
     }
 }
 
-bool rga_exec_cmd(uint8_t cmd, uint32_t addr, uint16_t payload_out, uint16_t *payload_in) {
-    uint16_t tx[8];
+int rga_encode_cmd(uint16_t *tx, uint8_t cmd, uint32_t addr, uint16_t payload_out) {
     int idx = 0;
 
     bool has_payload = (cmd == FTCMD_WRITE ||
@@ -49,6 +48,22 @@ bool rga_exec_cmd(uint8_t cmd, uint32_t addr, uint16_t payload_out, uint16_t *pa
     tx[idx] = calc_crc(tx, idx); idx++;
     tx[idx++] = ETX_MAGIC;
 
+    return idx;
+}
+
+bool rga_decode_reply(const uint16_t *rx, uint16_t *payload_in) {
+    if(rx[5] != ETX_MAGIC) return false;
+    if(rx[4] != calc_crc(rx, 4)) return false;
+    if(rx[1] != STATUS_OK) return false;
+
+    if (payload_in) *payload_in = rx[3];
+    return true;
+}
+
+bool rga_exec_cmd(uint8_t cmd, uint32_t addr, uint16_t payload_out, uint16_t *payload_in) {
+    uint16_t tx[RGA_MAX_FRAME];
+    int idx = rga_encode_cmd(tx, cmd, addr, payload_out);
+
     for(volatile int k=0; k<50; k++); 
     for(int i=0; i<idx; i++) *TX_FIFO_ADDR = tx[i];
 
@@ -66,12 +81,7 @@ bool rga_exec_cmd(uint8_t cmd, uint32_t addr, uint16_t payload_out, uint16_t *pa
     rx[0] = STX_MAGIC;
     for(int i=1; i<6; i++) rx[i] = *RX_FIFO_ADDR;
 
-    if(rx[5] != ETX_MAGIC) return false;
-    if(rx[4] != calc_crc(rx, 4)) return false;
-    if(rx[1] != STATUS_OK) return false;
-
-    if (payload_in) *payload_in = rx[3];
-    return true;
+    return rga_decode_reply(rx, payload_in);
 }
 
 #if 0
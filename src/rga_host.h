@@ -9,6 +9,11 @@
 #include <unistd.h>
 #include "rga_common.h"
 
+// Framing, a command frame is at most RGA_MAX_FRAME words, a reply 6 words
+#define RGA_MAX_FRAME 7
+int rga_encode_cmd(uint16_t *tx, uint8_t cmd, uint32_t addr, uint16_t payload_out);
+bool rga_decode_reply(const uint16_t *rx, uint16_t *payload_in);
+
 // Low-Level API
 bool rga_exec_cmd(uint8_t cmd, uint32_t addr, uint16_t payload_out, uint16_t *payload_in);
 
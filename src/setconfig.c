@@ -10,13 +10,28 @@
 #include <exec/types.h>
 #include <common/compiler.h>
 
+#include <proto/exec.h>
+
 #include "unicam.h"
 #include "mbox.h"
 
 void L_UnicamSetConfig(REGARG(ULONG cfg, "d0"), REGARG(struct UnicamBase * UnicamBase, "a6"))
 {
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+
+    ObtainSemaphore(&UnicamBase->u_Lock);
+
     UnicamBase->u_Integer = (cfg & UNICAMF_INTEGER) != 0;
     UnicamBase->u_Smooth = (cfg & UNICAMF_SMOOTHING) != 0;
     UnicamBase->u_Scaler = (cfg & UNICAMF_SCALER) >> UNICAMB_SCALER;
     UnicamBase->u_Phase = (cfg & UNICAMF_PHASE) >> UNICAMB_PHASE;
+
+    if (UnicamBase->u_Window != ((cfg & UNICAMF_WINDOW) != 0))
+    {
+        UnicamBase->u_Window = (cfg & UNICAMF_WINDOW) != 0;
+        UnicamBase->u_WindowPending = UnicamBase->u_Running;
+    }
+    UnicamBase->u_Generation++;
+
+    ReleaseSemaphore(&UnicamBase->u_Lock);
 }
@@ -11,6 +11,7 @@
 
 #include "unicam.h"
 #include "smoothing.h"
+#include "filters.h"
 
 // All computations use 24.8 fixed point
 
@@ -59,28 +60,23 @@ void compute_scaling_kernel(ULONG *dlist_memory, LONG b, LONG c)
 
     for (int i=0; i<11; i++) {
         if (i < 6) {
-            wr32le(&dlist_memory[i], half_kernel[i]);
+            dlist_memory[i] = half_kernel[i];
         } else {
-            wr32le(&dlist_memory[i], half_kernel[11 - i - 1]);
+            dlist_memory[i] = half_kernel[11 - i - 1];
         }
     }
 }
 
-void compute_nearest_neighbour_kernel(ULONG *dlist_memory)
+/* Expand one of the half kernels precomputed at build time into a symmetric kernel */
+void compute_filter_kernel(ULONG *dlist_memory, UBYTE filter)
 {
-    ULONG half_kernel[6] = {0, 0, 0, 0, 0, 0};
-
-    for (int i=0; i < 16; i++) {
-        int val = i < 8 ? 0 : 255;
-        half_kernel[i / 3] |= (val & 0x1ff) << (9 * (i % 3));
-    }
-    half_kernel[5] |= half_kernel[5] << 9;
+    const ULONG *half_kernel = filter_kernels[filter];
 
     for (int i=0; i<11; i++) {
         if (i < 6) {
-            wr32le(&dlist_memory[i], half_kernel[i]);
+            dlist_memory[i] = half_kernel[i];
         } else {
-            wr32le(&dlist_memory[i], half_kernel[11 - i - 1]);
+            dlist_memory[i] = half_kernel[11 - i - 1];
         }
     }
 }
@@ -4,6 +4,6 @@
 #include <exec/types.h>
 
 void compute_scaling_kernel(ULONG *dlist_memory, LONG b, LONG c);
-void compute_nearest_neighbour_kernel(ULONG *dlist_memory);
+void compute_filter_kernel(ULONG *dlist_memory, UBYTE filter);
 
 #endif /* _SMOOTHING_H */
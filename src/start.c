@@ -10,12 +10,34 @@
 #include <exec/types.h>
 #include <common/compiler.h>
 
+#include <proto/exec.h>
+
 #include "unicam.h"
 #include "mbox.h"
 
+/*
+    Start capture into address. If that is the receive buffer taken from Fast RAM, it grows first to
+    hold UnicamSetBuffers() frames of the given size. The framebuffer may move then, so callers have
+    to fetch it with UnicamGetFramebuffer() again after the start. The old block is freed once no
+    display list built by the resource shows it any more.
+*/
 void L_UnicamStart(REGARG(ULONG *address, "a0"), REGARG(UBYTE lanes, "d0"), REGARG(UBYTE datatype, "d1"),
                  REGARG(ULONG width, "d2"), REGARG(ULONG height, "d3"), REGARG(UBYTE bpp, "d4"),
                  REGARG(struct UnicamBase * UnicamBase, "a6"))
 {
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+
+    ObtainSemaphore(&UnicamBase->u_Lock);
+    MMIO_BEGIN(UnicamBase);
+
+    if (address == UnicamBase->u_ReceiveBuffer && UnicamBase->u_ReceiveAlloc != NULL)
+    {
+        unicam_alloc_receive(UnicamBase, width, height, bpp, UnicamBase->u_BufferCount);
+        address = UnicamBase->u_ReceiveBuffer;
+    }
+
     unicam_run(address, lanes, datatype, width, height, bpp, UnicamBase);
+    unicam_release_retired(UnicamBase);
+    mmio_report(UnicamBase, "UnicamStart");
+    ReleaseSemaphore(&UnicamBase->u_Lock);
 }
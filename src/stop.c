@@ -10,10 +10,19 @@
 #include <exec/types.h>
 #include <common/compiler.h>
 
+#include <proto/exec.h>
+
 #include "unicam.h"
 #include "mbox.h"
 
 void L_UnicamStop(REGARG(struct UnicamBase * UnicamBase, "a6"))
 {
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+
+    ObtainSemaphore(&UnicamBase->u_Lock);
+    MMIO_BEGIN(UnicamBase);
     unicam_stop(UnicamBase);
+    unicam_release_retired(UnicamBase);
+    mmio_report(UnicamBase, "UnicamStop");
+    ReleaseSemaphore(&UnicamBase->u_Lock);
 }
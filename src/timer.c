@@ -0,0 +1,41 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+
+#include "unicam.h"
+#include "timer.h"
+
+/*
+    All delays are based on the 1MHz system timer, so they do not depend on the speed of the JIT.
+    Differences of the counter values are taken, so wrapping over 32 bits is handled too.
+*/
+void timer_delay(ULONG us)
+{
+    ULONG start = systimer_read();
+
+    while (systimer_read() - start < us)
+        asm volatile("nop");
+}
+
+/*
+    Wait until the little endian register masked with mask equals value. Returns FALSE if this did
+    not happen within given timeout.
+*/
+BOOL timer_wait_reg(volatile ULONG *reg, ULONG mask, ULONG value, ULONG timeout_us)
+{
+    ULONG start = systimer_read();
+
+    do {
+        if ((rd32le(reg) & mask) == value)
+            return TRUE;
+    } while (systimer_read() - start < timeout_us);
+
+    return (rd32le(reg) & mask) == value;
+}
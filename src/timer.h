@@ -0,0 +1,9 @@
+#ifndef _TIMER_H
+#define _TIMER_H
+
+#include <exec/types.h>
+
+void timer_delay(ULONG us);
+BOOL timer_wait_reg(volatile ULONG *reg, ULONG mask, ULONG value, ULONG timeout_us);
+
+#endif /* _TIMER_H */
@@ -13,11 +13,9 @@
 #include "unicam.h"
 #include "mbox.h"
 #include "vc4-regs-unicam.h"
+#include "timer.h"
 
-#define BIT(n) (UINT32_C(1) << (n))
 #define u32 uint32_t
-#define AARCH 32
-#define GENMASK(h, l) ((~0UL - (1UL << (l)) + 1) & (~0UL >> (AARCH - 1 - (h))))
 
 #define ARM_IO_BASE ((ULONG)UnicamBase->u_PeriphBase)
 #define ARM_CSI0_BASE (ARM_IO_BASE + 0x800000)
@@ -33,50 +31,27 @@
 #define ARM_CM_CAM1DIV (ARM_CM_BASE + 0x4C)
 #define ARM_CM_PASSWD (0x5A << 24)
 
-void myusleep(ULONG us)
-{
-    ULONG count;
-    for (volatile ULONG count = us*100; count > 0; count--) {
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-        asm volatile("nop");asm volatile("nop");asm volatile("nop");
-	}
-}
+#define ARM_CM_BUSY (1 << 7)
+#define CLOCK_TIMEOUT 10000
 
 void setup_csiclk(struct UnicamBase * UnicamBase)
 {
-    *(volatile ULONG *)(ARM_CM_CAM1CTL) = LE32(ARM_CM_PASSWD | (1 << 5));
-    myusleep(100);
-    while ((*(volatile ULONG *)(ARM_CM_CAM1CTL)) & LE32(1 << 7)) {}
-    myusleep(100);
-    *(volatile ULONG *)(ARM_CM_CAM1DIV) =
-        LE32(ARM_CM_PASSWD | (4 << 12)); // divider , 12=100MHz on pi3 ??
-    myusleep(100);
-    *(volatile ULONG *)(ARM_CM_CAM1CTL) =
-        LE32(ARM_CM_PASSWD | 6 | (1 << 4)); // pll? 6=plld, 5=pllc
-    myusleep(100);
-    while (((*(volatile ULONG *)(ARM_CM_CAM1CTL)) & LE32(1 << 7)) == 0) {}
-    myusleep(100);
+    MMIO_WRITE(UnicamBase, 3);
+    wr32le((volatile ULONG *)(ARM_CM_CAM1CTL), ARM_CM_PASSWD | (1 << 5));
+    if (!timer_wait_reg((volatile ULONG *)(ARM_CM_CAM1CTL), ARM_CM_BUSY, 0, CLOCK_TIMEOUT))
+        bug("[unicam] CAM1 clock did not stop\n");
+    wr32le((volatile ULONG *)(ARM_CM_CAM1DIV),
+        ARM_CM_PASSWD | (4 << 12)); // divider , 12=100MHz on pi3 ??
+    wr32le((volatile ULONG *)(ARM_CM_CAM1CTL),
+        ARM_CM_PASSWD | 6 | (1 << 4)); // pll? 6=plld, 5=pllc
+    if (!timer_wait_reg((volatile ULONG *)(ARM_CM_CAM1CTL), ARM_CM_BUSY, ARM_CM_BUSY, CLOCK_TIMEOUT))
+        bug("[unicam] CAM1 clock did not start\n");
 }
 
 void ClockWrite(struct UnicamBase * UnicamBase, ULONG nValue)
 {
-    *(volatile ULONG *)(ARM_CSI1_CLKGATE) = LE32(ARM_CM_PASSWD | nValue);
+    MMIO_WRITE(UnicamBase, 1);
+    wr32le((volatile ULONG *)(ARM_CSI1_CLKGATE), ARM_CM_PASSWD | nValue);
 }
 
 void SetField(ULONG *pValue, ULONG nValue, ULONG nMask)
@@ -90,17 +65,71 @@ void SetField(ULONG *pValue, ULONG nValue, ULONG nMask)
     *pValue = (*pValue & ~nMask) | nValue;
 }
 
+/*
+    Configuration registers are mirrored in UnicamBase, so that field updates do not need to read them
+    back over the peripheral bus. Status, interrupt control and DMA pointer registers are never shadowed,
+    ICTL neither since LIP clears itself. Peripheral reset through CPR drops all copies but CTRL.
+*/
+static const UWORD shadow_regs[UNICAM_SHADOW_REGS] = {
+    UNICAM_CTRL, UNICAM_ANA, UNICAM_PRI, UNICAM_CLK, UNICAM_CLT,
+    UNICAM_DAT0, UNICAM_DAT1, UNICAM_DAT2, UNICAM_DAT3, UNICAM_DLT,
+    UNICAM_CMP0, UNICAM_CMP1, UNICAM_MISC
+};
+
+static int shadow_index(ULONG nOffset)
+{
+    for (int i=0; i < UNICAM_SHADOW_REGS; i++)
+    {
+        if (shadow_regs[i] == nOffset)
+            return i;
+    }
+
+    return -1;
+}
+
 ULONG ReadReg(struct UnicamBase * UnicamBase, ULONG nOffset)
 {
     ULONG temp;
-    temp = LE32(*(volatile ULONG *)(ARM_CSI1_BASE + nOffset));
+    int idx = shadow_index(nOffset);
+
+    if (idx >= 0 && (UnicamBase->u_ShadowValid & (1 << idx)))
+    {
+#ifdef UNICAM_SHADOW_CHECK
+        temp = rd32le((volatile ULONG *)(ARM_CSI1_BASE + nOffset));
+        if (temp != UnicamBase->u_Shadow[idx])
+            bug("[unicam] Shadow of register %03lx is %08lx, hardware has %08lx\n", nOffset, UnicamBase->u_Shadow[idx], temp);
+#endif
+        return UnicamBase->u_Shadow[idx];
+    }
+
+    MMIO_READ(UnicamBase, 1);
+    temp = rd32le((volatile ULONG *)(ARM_CSI1_BASE + nOffset));
+
+    if (idx >= 0)
+    {
+        UnicamBase->u_Shadow[idx] = temp;
+        UnicamBase->u_ShadowValid |= 1 << idx;
+    }
 
     return temp;
 }
 
 void WriteReg(struct UnicamBase * UnicamBase, ULONG nOffset, ULONG nValue)
 {
-    *(volatile ULONG *)(ARM_CSI1_BASE + nOffset) = LE32(nValue);
+    int idx = shadow_index(nOffset);
+
+    MMIO_WRITE(UnicamBase, 1);
+    wr32le((volatile ULONG *)(ARM_CSI1_BASE + nOffset), nValue);
+
+    if (idx >= 0)
+    {
+        /* Peripheral reset returns all other registers to their defaults */
+        if (nOffset == UNICAM_CTRL && (nValue & UNICAM_CPR))
+            UnicamBase->u_ShadowValid = 0;
+
+        UnicamBase->u_Shadow[idx] = nValue;
+        UnicamBase->u_ShadowValid |= 1 << idx;
+    }
 }
 
 void WriteRegField(struct UnicamBase * UnicamBase, ULONG nOffset, ULONG nValue, ULONG nMask)
@@ -110,16 +139,63 @@ void WriteRegField(struct UnicamBase * UnicamBase, ULONG nOffset, ULONG nValue,
     WriteReg(UnicamBase, nOffset, nBuffer);
 }
 
+/*
+    Split the capture area into frame buffers. Multiple buffers are used only when capturing into
+    u_ReceiveBuffer, since only then the size of the area is known. The buffer count is reduced
+    until all of them fit.
+*/
+void unicam_setup_buffers(struct UnicamBase * UnicamBase)
+{
+    ULONG slot = (UnicamBase->u_FrameSize + UNICAM_SLOT_ALIGN - 1) & ~(UNICAM_SLOT_ALIGN - 1);
+    UBYTE count = UnicamBase->u_BufferCount;
+
+    if (UnicamBase->u_CaptureAddress != UnicamBase->u_ReceiveBuffer)
+        count = 1;
+
+    while (count > 1 && count * slot > UnicamBase->u_ReceiveBufferSize)
+        count--;
+
+    if (count == 0)
+        count = 1;
+
+    for (int i=0; i < count; i++)
+    {
+        UnicamBase->u_Buffers[i] = (APTR)((ULONG)UnicamBase->u_CaptureAddress + i * slot);
+    }
+
+    UnicamBase->u_ActiveBuffers = count;
+    UnicamBase->u_WriteBuffer = 0;
+    UnicamBase->u_DisplayBuffer = 0;
+}
+
+void unicam_set_buffer(struct UnicamBase * UnicamBase, UBYTE index)
+{
+    ULONG start = (ULONG)UnicamBase->u_Buffers[index];
+
+    UnicamBase->u_QueuedBuffer = index;
+
+    WriteReg(UnicamBase, UNICAM_IBSA0, start & ~0xC0000000 | 0xC0000000);
+    WriteReg(UnicamBase, UNICAM_IBEA0, (start + UnicamBase->u_FrameSize) & ~0xC0000000 | 0xC0000000);
+}
+
 void unicam_run(ULONG *address , UBYTE lanes, UBYTE datatype, ULONG width , ULONG height , UBYTE bbp, struct UnicamBase * UnicamBase)
 {
+    if (lanes == 0)
+        lanes = 1;
+    if (lanes > UNICAM_MAX_LANES)
+        lanes = UNICAM_MAX_LANES;
+
     //enable power domain
     enable_unicam_domain(UnicamBase);
 
     //enable to clock to unicam
     setup_csiclk(UnicamBase);
 
-    // Enable lane clocks (2 lanes)
-    ClockWrite(UnicamBase, 0b010101);
+    // Enable clocks of the clock lane and of every used data lane
+    ULONG nGate = 0b01;
+    for (int i=0; i < lanes; i++)
+        nGate |= 0b01 << (2 + 2 * i);
+    ClockWrite(UnicamBase, nGate);
 
     // Basic init
     WriteReg(UnicamBase, UNICAM_CTRL, UNICAM_MEM);
@@ -130,7 +206,7 @@ void unicam_run(ULONG *address , UBYTE lanes, UBYTE datatype, ULONG width , ULON
     SetField(&nValue, 7, UNICAM_PTATADJ_MASK);
     WriteReg(UnicamBase, UNICAM_ANA, nValue);
 
-    myusleep(1000);
+    timer_delay(1000);
 
     // Come out of reset
     WriteRegField(UnicamBase, UNICAM_ANA, 0, UNICAM_AR);
@@ -151,8 +227,6 @@ void unicam_run(ULONG *address , UBYTE lanes, UBYTE datatype, ULONG width , ULON
     SetField(&nValue, 128, UNICAM_OET_MASK);
     WriteReg(UnicamBase, UNICAM_CTRL, nValue);
 
-    WriteReg(UnicamBase, UNICAM_IHWIN, 0);
-    WriteReg(UnicamBase, UNICAM_IVWIN, 0);
 
     // AXI bus access QoS setup
     nValue = ReadReg(UnicamBase, UNICAM_PRI);
@@ -176,7 +250,7 @@ void unicam_run(ULONG *address , UBYTE lanes, UBYTE datatype, ULONG width , ULON
     WriteRegField(UnicamBase, UNICAM_CLT, 2, UNICAM_CLT1_MASK); // tclk_term_en
     WriteRegField(UnicamBase, UNICAM_CLT, 6, UNICAM_CLT2_MASK); // tclk_settle
     WriteRegField(UnicamBase, UNICAM_DLT, 2, UNICAM_DLT1_MASK); // td_term_en
-    WriteRegField(UnicamBase, UNICAM_DLT, 6, UNICAM_DLT2_MASK); // ths_settle
+    WriteRegField(UnicamBase, UNICAM_DLT, csi_ths_settle(UnicamBase->u_LinkRate), UNICAM_DLT2_MASK); // ths_settle
     WriteRegField(UnicamBase, UNICAM_DLT, 0, UNICAM_DLT3_MASK); // trx_enable
 
     WriteRegField(UnicamBase, UNICAM_CTRL, 0, UNICAM_SOE);
@@ -199,23 +273,26 @@ void unicam_run(ULONG *address , UBYTE lanes, UBYTE datatype, ULONG width , ULON
     // Enable required data lanes with appropriate terminations.
     // The same value needs to be written to UNICAM_DATn registers for
     // the active lanes, and 0 for inactive ones.
-    // (CSI2 DPHY, non-continous clock, 2 data lanes)
+    // (CSI2 DPHY, non-continous clock)
     nValue = 0;
     SetField(&nValue, 1, UNICAM_DLE);
     SetField(&nValue, 1, UNICAM_DLLPE);
     WriteReg(UnicamBase, UNICAM_DAT0, nValue);
-    if (lanes == 1)
-        WriteReg(UnicamBase, UNICAM_DAT1, 0);
-    if (lanes == 2)
-        WriteReg(UnicamBase, UNICAM_DAT1, nValue);
-
-    WriteReg(UnicamBase, UNICAM_IBLS, width*(bbp/8));
-
-    // Write DMA buffer address
-
-    WriteReg(UnicamBase, UNICAM_IBSA0, (u32)(address) & ~0xC0000000 | 0xC0000000);
-    WriteReg(UnicamBase, UNICAM_IBEA0,
-            (ULONG)(address + (width * height * (bbp/8))) & ~0xC0000000 | 0xC0000000);
+    WriteReg(UnicamBase, UNICAM_DAT1, lanes > 1 ? nValue : 0);
+    WriteReg(UnicamBase, UNICAM_DAT2, lanes > 2 ? nValue : 0);
+    WriteReg(UnicamBase, UNICAM_DAT3, lanes > 3 ? nValue : 0);
+
+    // Capture window and line stride
+    UnicamBase->u_CaptureBPP = bbp;
+    UnicamBase->u_CaptureSize.width = width;
+    UnicamBase->u_CaptureSize.height = height;
+    unicam_set_window(UnicamBase);
+
+    // Write DMA buffer address of the first frame buffer
+    UnicamBase->u_CaptureAddress = address;
+    UnicamBase->u_FrameSize = unicam_line_stride(UnicamBase, width, bbp) * height;
+    unicam_setup_buffers(UnicamBase);
+    unicam_set_buffer(UnicamBase, 0);
 
     // Set packing configuration
     ULONG nUnPack = UNICAM_PUM_NONE;
@@ -240,12 +317,110 @@ void unicam_run(ULONG *address , UBYTE lanes, UBYTE datatype, ULONG width , ULON
     // Enable peripheral
     WriteRegField(UnicamBase, UNICAM_CTRL, 1, UNICAM_CPE);
 
-    // Load image pointers
+    // Load image pointers, the second buffer is queued once the first frame has started
+    WriteRegField(UnicamBase, UNICAM_ICTL, 1, UNICAM_LIP_MASK);
+
+    UnicamBase->u_Lanes = lanes;
+    UnicamBase->u_WatchdogArmed = FALSE;
+    UnicamBase->u_Recovering = FALSE;
+    UnicamBase->u_StallRetries = 0;
+    UnicamBase->u_FramePeriod = 0;
+    framestats_reset(&UnicamBase->u_FrameStats);
+    UnicamBase->u_Running = TRUE;
+    unicam_add_interrupt(UnicamBase);
+}
+
+/*
+    Program the capture window. With the window enabled only the crop rectangle is captured, its lines
+    packed one after another, and the crop offset moves the window instead of the plane on screen.
+    Otherwise the whole frame is captured and cropped by the HVS. Horizontal window counts bytes of
+    the line, vertical one lines.
+*/
+void unicam_set_window(struct UnicamBase * UnicamBase)
+{
+    ULONG bpp = UnicamBase->u_CaptureBPP / 8;
+    struct Point offset;
+    struct Size size;
+    ULONG hwin = 0;
+    ULONG vwin = 0;
+
+    UnicamBase->u_WindowPending = FALSE;
+
+    if (unicam_get_window(UnicamBase, &offset, &size))
+    {
+        SetField(&hwin, offset.x * bpp, UNICAM_WSTART_MASK);
+        SetField(&hwin, (offset.x + size.width) * bpp - 1, UNICAM_WEND_MASK);
+        SetField(&vwin, offset.y, UNICAM_WSTART_MASK);
+        SetField(&vwin, offset.y + size.height - 1, UNICAM_WEND_MASK);
+    }
+
+    WriteReg(UnicamBase, UNICAM_IHWIN, hwin);
+    WriteReg(UnicamBase, UNICAM_IVWIN, vwin);
+    WriteReg(UnicamBase, UNICAM_IBLS, unicam_line_stride(UnicamBase, size.width, UnicamBase->u_CaptureBPP));
+}
+
+/*
+    Minimal restart of a stalled receiver: peripheral reset, restore of the configuration, new image
+    pointers. Power domain, clocks and lane timing set up by unicam_run() are left alone.
+*/
+void unicam_restart(struct UnicamBase * UnicamBase)
+{
+    ULONG saved[UNICAM_SHADOW_REGS];
+    ULONG valid = UnicamBase->u_ShadowValid;
+    UBYTE count = UnicamBase->u_ActiveBuffers;
+
+    for (int i=0; i < UNICAM_SHADOW_REGS; i++)
+        saved[i] = UnicamBase->u_Shadow[i];
+
+    ULONG ictl = ReadReg(UnicamBase, UNICAM_ICTL) & ~UNICAM_LIP_MASK;
+    ULONG idi0 = ReadReg(UnicamBase, UNICAM_IDI0);
+    ULONG ipipe = ReadReg(UnicamBase, UNICAM_IPIPE);
+    ULONG ibls = ReadReg(UnicamBase, UNICAM_IBLS);
+    ULONG ihwin = ReadReg(UnicamBase, UNICAM_IHWIN);
+    ULONG ivwin = ReadReg(UnicamBase, UNICAM_IVWIN);
+
+    // Peripheral reset
+    WriteRegField(UnicamBase, UNICAM_CTRL, 1, UNICAM_CPR);
+    timer_delay(50);
+    WriteRegField(UnicamBase, UNICAM_CTRL, 0, UNICAM_CPR);
+
+    // Restore configuration, CTRL with the peripheral enable bit goes last
+    for (int i=1; i < UNICAM_SHADOW_REGS; i++)
+    {
+        if (valid & (1 << i))
+            WriteReg(UnicamBase, shadow_regs[i], saved[i]);
+    }
+
+    WriteReg(UnicamBase, UNICAM_IDI0, idi0);
+    WriteReg(UnicamBase, UNICAM_IPIPE, ipipe);
+    WriteReg(UnicamBase, UNICAM_IBLS, ibls);
+    WriteReg(UnicamBase, UNICAM_IHWIN, ihwin);
+    WriteReg(UnicamBase, UNICAM_IVWIN, ivwin);
+    WriteReg(UnicamBase, UNICAM_STA, UNICAM_STA_MASK_ALL);
+    WriteReg(UnicamBase, UNICAM_ISTA, UNICAM_ISTA_MASK_ALL);
+    WriteReg(UnicamBase, UNICAM_ICTL, ictl);
+
+    // Capture into the buffer following the one on screen
+    if (count > 1)
+        UnicamBase->u_WriteBuffer = UnicamBase->u_DisplayBuffer + 1 < count ? UnicamBase->u_DisplayBuffer + 1 : 0;
+    else
+        UnicamBase->u_WriteBuffer = 0;
+    unicam_set_buffer(UnicamBase, UnicamBase->u_WriteBuffer);
+
+    WriteReg(UnicamBase, UNICAM_CTRL, saved[0] & ~UNICAM_CPR);
+
+    // Load image pointers, the following buffer is queued once a frame has started
     WriteRegField(UnicamBase, UNICAM_ICTL, 1, UNICAM_LIP_MASK);
+
+    UnicamBase->u_InFrame = FALSE;
 }
 
 void unicam_stop(struct UnicamBase * UnicamBase)
 {
+    unicam_rem_interrupt(UnicamBase);
+    UnicamBase->u_Running = FALSE;
+    unicam_wake_waiters(UnicamBase);
+
     // Analogue lane control disable
     WriteRegField(UnicamBase, UNICAM_ANA, 1, UNICAM_DDL);
 
@@ -255,10 +430,12 @@ void unicam_stop(struct UnicamBase * UnicamBase)
     // Disable the data lanes
     WriteReg(UnicamBase, UNICAM_DAT0, 0);
     WriteReg(UnicamBase, UNICAM_DAT1, 0);
+    WriteReg(UnicamBase, UNICAM_DAT2, 0);
+    WriteReg(UnicamBase, UNICAM_DAT3, 0);
 
     // Peripheral reset
     WriteRegField(UnicamBase, UNICAM_CTRL, 1, UNICAM_CPR);
-    myusleep(50);
+    timer_delay(50);
     WriteRegField(UnicamBase, UNICAM_CTRL, 0, UNICAM_CPR);
 
     // Disable peripheral
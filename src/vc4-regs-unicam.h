@@ -8,6 +8,12 @@
 #ifndef VC4_REGS_UNICAM_H
 #define VC4_REGS_UNICAM_H
 
+#ifndef BIT
+#define BIT(n) (UINT32_C(1) << (n))
+#define AARCH (__SIZEOF_LONG__ * 8)
+#define GENMASK(h, l) ((~0UL - (1UL << (l)) + 1) & (~0UL >> (AARCH - 1 - (h))))
+#endif
+
 /*
  * The following values are taken from files found within the code drop
  * made by Broadcom for the BCM21553 Graphics Driver, predominantly in
@@ -210,6 +216,10 @@
 #define UNICAM_ICM_MASK GENMASK(16, 15)
 #define UNICAM_IDM_MASK GENMASK(17, 17)
 
+/* UNICAM_IHWIN/IVWIN Registers, first and last byte of a line, first and last line. 0 disables */
+#define UNICAM_WSTART_MASK GENMASK(15, 0)
+#define UNICAM_WEND_MASK GENMASK(31, 16)
+
 /* UNICAM_ICC Register */
 #define UNICAM_ICFL_MASK GENMASK(4, 0)
 #define UNICAM_ICFH_MASK GENMASK(9, 5)
@@ -25,116 +25,129 @@
 #include "videocore.h"
 #include "smoothing.h"
 
-/* Unicam DisplayList */
-void VC4_ConstructUnicamDL(struct UnicamBase *UnicamBase, ULONG kernel)
+/* Control word of the plane, indexed by [VC6][unity]. Plane length follows from the word count field */
+static const ULONG control_bits[2][2] = {
+    {
+        CONTROL_VALID | CONTROL_WORDS(16) | 0x01800,
+        CONTROL_VALID | CONTROL_WORDS(7) | CONTROL_UNITY
+    },
+    {
+        VC6_CONTROL_VALID | VC6_CONTROL_WORDS(17) | VC6_CONTROL_ALPHA_EXPAND | VC6_CONTROL_RGB_EXPAND,
+        VC6_CONTROL_VALID | VC6_CONTROL_WORDS(8) | VC6_CONTROL_UNITY | VC6_CONTROL_ALPHA_EXPAND | VC6_CONTROL_RGB_EXPAND
+    }
+};
+
+/* Space reserved for the plane below 0x300 in HVS display list memory, indexed by [VC6][unity] */
+static const UBYTE hvs_reserve[2][2] = {
+    { 32, 16 },
+    { 24, 16 }
+};
+
+#define PLANE_WORDS(control) ((((control) >> 24) & 0x3f) + 1)
+
+/* YUV planes carry the colour space converter words behind the pitch */
+static ULONG plane_words(struct UnicamBase *UnicamBase, BOOL unity)
 {
-    int unity = 0;
-    ULONG scale_x = 0;
-    ULONG scale_y = 0;
-    ULONG scale = 0;
-    ULONG recip_x = 0;
-    ULONG recip_y = 0;
-    ULONG calc_width = 0;
-    ULONG calc_height = 0;
-    ULONG offset_x = 0;
-    ULONG offset_y = 0;
+    ULONG words = PLANE_WORDS(control_bits[UnicamBase->u_IsVC6 ? 1 : 0][unity]);
+
+    if (UNICAM_IS_YUV(UnicamBase))
+        words += DL_CSC_WORDS;
 
-    ULONG cnt = 0x300; // Initial pointer to UnicamDL
+    return words;
+}
+
+struct PlaneGeometry {
+    BOOL    unity;
+    ULONG   scale_x;
+    ULONG   scale_y;
+    ULONG   width;
+    ULONG   height;
+    ULONG   offset_x;
+    ULONG   offset_y;
+};
+
+/* Scaling factors, size and position of the plane on screen */
+static void compute_geometry(struct UnicamBase *UnicamBase, struct PlaneGeometry *geo)
+{
+    ULONG scale;
 
-    volatile ULONG *displist = (ULONG *)((ULONG)UnicamBase->u_PeriphBase + 0x00402000);
+    geo->unity = FALSE;
+    geo->scale_x = 0;
+    geo->scale_y = 0;
+    geo->width = UnicamBase->u_Size.width;
+    geo->height = UnicamBase->u_Size.height;
+    geo->offset_x = 0;
+    geo->offset_y = 0;
 
     if (UnicamBase->u_Size.width == UnicamBase->u_DisplaySize.width &&
         UnicamBase->u_Size.height == UnicamBase->u_DisplaySize.height && UnicamBase->u_Aspect == 1000)
     {
-        unity = 1;
+        geo->unity = TRUE;
+        return;
     }
-    else
-    {
-        scale_x = 0x10000 * ((UnicamBase->u_Size.width * UnicamBase->u_Aspect) / 1000) / UnicamBase->u_DisplaySize.width;
-        scale_y = 0x10000 * UnicamBase->u_Size.height / UnicamBase->u_DisplaySize.height;
-
-        recip_x = 0xffffffff / scale_x;
-        recip_y = 0xffffffff / scale_y;
-
-        // Select larger scaling factor from X and Y, but it need to fit
-        if (((0x10000 * UnicamBase->u_Size.height) / scale_x) > UnicamBase->u_DisplaySize.height) {
-            scale = scale_y;
-        }
-        else {
-            scale = scale_x;
-        }
 
-        if (UnicamBase->u_Integer)
-        {
-            scale = 0x10000 / (ULONG)(0x10000 / scale);
-        }
+    geo->scale_x = 0x10000 * ((UnicamBase->u_Size.width * UnicamBase->u_Aspect) / 1000) / UnicamBase->u_DisplaySize.width;
+    geo->scale_y = 0x10000 * UnicamBase->u_Size.height / UnicamBase->u_DisplaySize.height;
 
-        scale_x = scale * 1000 / UnicamBase->u_Aspect;
-        scale_y = scale;
-
-        calc_width = (0x10000 * UnicamBase->u_Size.width) / scale_x;
-        calc_height = (0x10000 * UnicamBase->u_Size.height) / scale_y;
-
-        offset_x = (UnicamBase->u_DisplaySize.width - calc_width) >> 1;
-        offset_y = (UnicamBase->u_DisplaySize.height - calc_height) >> 1;
+    // Select larger scaling factor from X and Y, but it need to fit
+    if (((0x10000 * UnicamBase->u_Size.height) / geo->scale_x) > UnicamBase->u_DisplaySize.height) {
+        scale = geo->scale_y;
+    }
+    else {
+        scale = geo->scale_x;
     }
 
-    ULONG startAddress = (ULONG)UnicamBase->u_ReceiveBuffer;
-    startAddress += UnicamBase->u_Offset.x * (UnicamBase->u_BPP / 8);
-    startAddress += UnicamBase->u_Offset.y * UnicamBase->u_FullSize.width * (UnicamBase->u_BPP / 8);
-
-    if (unity)
+    if (UnicamBase->u_Integer)
     {
-        /* Unity scaling is simple, reserve less space for display list */
-        cnt -= 16;
+        scale = 0x10000 / (ULONG)(0x10000 / scale);
+    }
 
-        UnicamBase->u_UnicamDL = cnt;
+    geo->scale_x = scale * 1000 / UnicamBase->u_Aspect;
+    geo->scale_y = scale;
 
-        /* Set control reg */
-        ULONG control = 
-            CONTROL_VALID
-            | CONTROL_WORDS(7)
-            | CONTROL_UNITY;
-        
-        if (UnicamBase->u_PixelOrder == 0)
-            control |= CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XRGB);
-        else
-            control |= CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XBGR);
+    geo->width = (0x10000 * UnicamBase->u_Size.width) / geo->scale_x;
+    geo->height = (0x10000 * UnicamBase->u_Size.height) / geo->scale_y;
 
-        if (UnicamBase->u_BPP == 16)
-            control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_RGB565);
-        else if (UnicamBase->u_BPP == 24)
-            control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_RGB888);
+    if (geo->width > UnicamBase->u_DisplaySize.width) {
+        geo->width = UnicamBase->u_DisplaySize.width;
+    }
 
-        wr32le(&displist[cnt++], control);
+    if (geo->height > UnicamBase->u_DisplaySize.height) {
+        geo->height = UnicamBase->u_DisplaySize.height;
+    }
 
-        /* Center it on the screen */
-        wr32le(&displist[cnt++], POS0_X(offset_x) | POS0_Y(offset_y) | POS0_ALPHA(0xff));
-        wr32le(&displist[cnt++], POS2_H(UnicamBase->u_Size.height) | POS2_W(UnicamBase->u_Size.width) | (1 << 30));
-        wr32le(&displist[cnt++], 0xdeadbeef);
+    geo->offset_x = (UnicamBase->u_DisplaySize.width - geo->width) >> 1;
+    geo->offset_y = (UnicamBase->u_DisplaySize.height - geo->height) >> 1;
+}
 
-        /* Set address */
-        wr32le(&displist[cnt++], 0xc0000000 | (ULONG)startAddress);
-        wr32le(&displist[cnt++], 0xdeadbeef);
+/*
+    Compose the plane in host byte order. VC4 and VC6 planes differ only in position and alpha words,
+    unity planes lack the scaler part. Returns plane length, index of the address word in *addr_word.
+*/
+static ULONG emit_plane(struct UnicamBase *UnicamBase, const struct PlaneGeometry *geo, ULONG *buf, ULONG kernel, ULONG *addr_word)
+{
+    BOOL vc6 = UnicamBase->u_IsVC6 ? TRUE : FALSE;
+    ULONG control = control_bits[vc6][geo->unity];
+    ULONG kernel_v = kernel + unicam_kernel_size(UnicamBase) - DL_KERNEL_WORDS;
+    BOOL yuv = UNICAM_IS_YUV(UnicamBase);
+    ULONG cnt = 0;
 
-        /* Pitch is full width, always */
-        wr32le(&displist[cnt++], UnicamBase->u_FullSize.width * (UnicamBase->u_BPP / 8));
+    if (yuv)
+    {
+        /*
+            Interleaved 4:2:2 is fetched as a single plane, the HVS converts it to RGB before scaling.
+            Pixel order selects between Cb and Cr first, the same way it swaps R and B otherwise.
+        */
+        control += CONTROL_WORDS(DL_CSC_WORDS);
+        control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_YCBCR_YUV422_2PLANE);
 
-        /* Done */
-        wr32le(&displist[cnt++], 0x80000000);
+        if (UnicamBase->u_PixelOrder == 0)
+            control |= CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XYCBCR);
+        else
+            control |= CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XYCRCB);
     }
     else
     {
-        cnt -= 32;
-        
-        UnicamBase->u_UnicamDL = cnt;
-
-        /* Set control reg */
-        ULONG control = 
-            CONTROL_VALID
-            | CONTROL_WORDS(16)
-            | 0x01800;
-        
         if (UnicamBase->u_PixelOrder == 0)
             control |= CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XRGB);
         else
@@ -144,195 +157,223 @@ void VC4_ConstructUnicamDL(struct UnicamBase *UnicamBase, ULONG kernel)
             control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_RGB565);
         else if (UnicamBase->u_BPP == 24)
             control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_RGB888);
+    }
 
-        wr32le(&displist[cnt++], control);
+    buf[cnt++] = control;
 
-        /* Center plane on the screen */
-        wr32le(&displist[cnt++], POS0_X(offset_x) | POS0_Y(offset_y) | POS0_ALPHA(0xff));
-        wr32le(&displist[cnt++], POS1_H(calc_height) | POS1_W(calc_width));
-        wr32le(&displist[cnt++], POS2_H(UnicamBase->u_Size.height) | POS2_W(UnicamBase->u_Size.width) |
-                               (SCALER_POS2_ALPHA_MODE_FIXED << SCALER_POS2_ALPHA_MODE_SHIFT));
-        wr32le(&displist[cnt++], 0xdeadbeef); // Scratch written by HVS
+    /* Center plane on the screen */
+    if (vc6) {
+        buf[cnt++] = VC6_POS0_X(geo->offset_x) | VC6_POS0_Y(geo->offset_y);
+        buf[cnt++] = (VC6_SCALER_POS2_ALPHA_MODE_FIXED << VC6_SCALER_POS2_ALPHA_MODE_SHIFT) | VC6_SCALER_POS2_ALPHA(0xfff);
+        if (!geo->unity)
+            buf[cnt++] = VC6_POS1_H(geo->height) | VC6_POS1_W(geo->width);
+        buf[cnt++] = VC6_POS2_H(UnicamBase->u_Size.height) | VC6_POS2_W(UnicamBase->u_Size.width);
+    }
+    else {
+        buf[cnt++] = POS0_X(geo->offset_x) | POS0_Y(geo->offset_y) | POS0_ALPHA(0xff);
+        if (!geo->unity)
+            buf[cnt++] = POS1_H(geo->height) | POS1_W(geo->width);
+        buf[cnt++] = POS2_H(UnicamBase->u_Size.height) | POS2_W(UnicamBase->u_Size.width) |
+                     (SCALER_POS2_ALPHA_MODE_FIXED << SCALER_POS2_ALPHA_MODE_SHIFT);
+    }
+    buf[cnt++] = 0xdeadbeef; // Scratch written by HVS
+
+    /* Set address */
+    *addr_word = cnt;
+    buf[cnt++] = 0xc0000000 | unicam_display_address(UnicamBase);
+    buf[cnt++] = 0xdeadbeef;
 
-        /* Set address and pitch */
-        wr32le(&displist[cnt++], 0xc0000000 | startAddress);
-        wr32le(&displist[cnt++], 0xdeadbeef);
+    /* Pitch is the padded line of the full frame or of the capture window */
+    buf[cnt++] = unicam_stride(UnicamBase);
 
-        /* Pitch is full width, always */
-        wr32le(&displist[cnt++], UnicamBase->u_FullSize.width * (UnicamBase->u_BPP / 8));
+    if (yuv)
+    {
+        buf[cnt++] = SCALER_CSC0_ITR_R_601_5;
+        buf[cnt++] = SCALER_CSC1_ITR_R_601_5;
+        buf[cnt++] = SCALER_CSC2_ITR_R_601_5;
+    }
 
+    if (!geo->unity)
+    {
         /* LMB address */
-        wr32le(&displist[cnt++], 0);
+        buf[cnt++] = 0;
 
         /* Set PPF Scaler */
-        wr32le(&displist[cnt++], (scale_x << 8) | (UnicamBase->u_Scaler << 30) | UnicamBase->u_Phase);
-        wr32le(&displist[cnt++], (scale_y << 8) | (UnicamBase->u_Scaler << 30) | UnicamBase->u_Phase);
-        wr32le(&displist[cnt++], 0); // Scratch written by HVS
+        buf[cnt++] = (geo->scale_x << 8) | ((ULONG)UnicamBase->u_Scaler << 30) | UnicamBase->u_Phase;
+        buf[cnt++] = (geo->scale_y << 8) | ((ULONG)UnicamBase->u_Scaler << 30) | UnicamBase->u_Phase;
+        buf[cnt++] = 0; // Scratch written by HVS
+
+        /* Horizontal and vertical kernel of both PPF planes */
+        buf[cnt++] = kernel;
+        buf[cnt++] = kernel_v;
+        buf[cnt++] = kernel;
+        buf[cnt++] = kernel_v;
+    }
 
-        wr32le(&displist[cnt++], kernel);
-        wr32le(&displist[cnt++], kernel);
-        wr32le(&displist[cnt++], kernel);
-        wr32le(&displist[cnt++], kernel);
+    /* Done */
+    buf[cnt++] = 0x80000000;
 
-        /* Done */
-        wr32le(&displist[cnt++], 0x80000000);
-    }
+    return cnt;
 }
 
-
-void VC6_ConstructUnicamDL(struct UnicamBase *UnicamBase, ULONG kernel)
+/* Copy words composed in cached memory to the display list, swapping them to little endian on the way */
+static void copy_to_hvs(volatile ULONG *dst, const ULONG *src, ULONG count)
 {
-    int unity = 0;
-    ULONG scale_x = 0;
-    ULONG scale_y = 0;
-    ULONG scale = 0;
-    ULONG recip_x = 0;
-    ULONG recip_y = 0;
-    ULONG calc_width = 0;
-    ULONG calc_height = 0;
-    ULONG offset_x = 0;
-    ULONG offset_y = 0;
+    for (ULONG i=0; i < count; i++)
+        dst[i] = LE32(src[i]);
 
-    ULONG cnt = 0x300; // Initial pointer to UnicamDL
+    asm volatile("nop");
+}
 
-    volatile ULONG *displist = (ULONG *)((ULONG)UnicamBase->u_PeriphBase + 0x00404000);
+/* UNICAM_FILTER_DEFAULT follows the smoothing flag */
+static UBYTE resolve_filter(struct UnicamBase *UnicamBase, UBYTE filter)
+{
+    if (filter == UNICAM_FILTER_DEFAULT || filter >= UNICAM_FILTER_COUNT)
+        filter = UnicamBase->u_Smooth ? UNICAM_FILTER_MITCHELL : UNICAM_FILTER_NEAREST;
 
-    if (UnicamBase->u_Size.width == UnicamBase->u_DisplaySize.width &&
-        UnicamBase->u_Size.height == UnicamBase->u_DisplaySize.height && UnicamBase->u_Aspect == 1000)
-    {
-        unity = 1;
-    }
+    return filter;
+}
+
+/* Kernel words, doubled if horizontal and vertical filters differ */
+ULONG unicam_kernel_size(struct UnicamBase *UnicamBase)
+{
+    if (resolve_filter(UnicamBase, UnicamBase->u_FilterH) == resolve_filter(UnicamBase, UnicamBase->u_FilterV))
+        return DL_KERNEL_WORDS;
     else
+        return 2 * DL_KERNEL_WORDS;
+}
+
+ULONG unicam_dl_size(struct UnicamBase *UnicamBase)
+{
+    return plane_words(UnicamBase, FALSE) + unicam_kernel_size(UnicamBase);
+}
+
+/*
+    Write plane for the current configuration to dlist[offset]. If the plane scales and kernel_after
+    is set, the scaling kernel is written directly behind the plane and the kernel argument is ignored.
+    Returns the number of plane words.
+
+    The last fragment is kept in UnicamBase. As long as no setter has bumped the generation counter
+    and the placement is the same, it is only copied again. The address word is refreshed each time,
+    since crop offset and buffer flips change it without touching the rest of the plane.
+
+    Buffer flips patch only the plane registered with UnicamRegisterDL(). If that plane is rewritten,
+    its address word may move, so the copy and the new location are made atomic to the flip.
+*/
+ULONG unicam_write_dl(struct UnicamBase *UnicamBase, volatile ULONG *dlist, ULONG offset, ULONG kernel, BOOL kernel_after)
+{
+    ULONG *buf = UnicamBase->u_DLCache;
+    ULONG key = kernel_after ? DL_KERNEL_AFTER : kernel;
+
+    if (UnicamBase->u_DLCacheGeneration != UnicamBase->u_Generation ||
+        UnicamBase->u_DLCacheOffset != offset || UnicamBase->u_DLCacheKernel != key)
     {
-        scale_x = 0x10000 * ((UnicamBase->u_Size.width * UnicamBase->u_Aspect) / 1000) / UnicamBase->u_DisplaySize.width;
-        scale_y = 0x10000 * UnicamBase->u_Size.height / UnicamBase->u_DisplaySize.height;
+        struct PlaneGeometry geo;
+        ULONG addr_word;
+        ULONG cnt;
+        ULONG total;
 
-        recip_x = 0xffffffff / scale_x;
-        recip_y = 0xffffffff / scale_y;
+        compute_geometry(UnicamBase, &geo);
 
-        // Select larger scaling factor from X and Y, but it need to fit
-        if (((0x10000 * UnicamBase->u_Size.height) / scale_x) > UnicamBase->u_DisplaySize.height) {
-            scale = scale_y;
-        }
-        else {
-            scale = scale_x;
-        }
+        if (kernel_after)
+            kernel = offset + plane_words(UnicamBase, geo.unity);
+
+        cnt = emit_plane(UnicamBase, &geo, buf, kernel, &addr_word);
+        total = cnt;
 
-        if (UnicamBase->u_Integer)
+        if (kernel_after && !geo.unity)
         {
-            scale = 0x10000 / (ULONG)(0x10000 / scale);
+            total += unicam_emit_kernel(UnicamBase, &buf[cnt]);
         }
 
-        scale_x = scale * 1000 / UnicamBase->u_Aspect;
-        scale_y = scale;
-
-        calc_width = (0x10000 * UnicamBase->u_Size.width) / scale_x;
-        calc_height = (0x10000 * UnicamBase->u_Size.height) / scale_y;
-
-        offset_x = (UnicamBase->u_DisplaySize.width - calc_width) >> 1;
-        offset_y = (UnicamBase->u_DisplaySize.height - calc_height) >> 1;
+        UnicamBase->u_DLCacheGeneration = UnicamBase->u_Generation;
+        UnicamBase->u_DLCacheOffset = offset;
+        UnicamBase->u_DLCacheKernel = key;
+        UnicamBase->u_DLCachePlane = cnt;
+        UnicamBase->u_DLCacheWords = total;
+        UnicamBase->u_DLCacheAddress = addr_word;
+    }
+    else
+    {
+        buf[UnicamBase->u_DLCacheAddress] = 0xc0000000 | unicam_display_address(UnicamBase);
     }
 
-    ULONG startAddress = (ULONG)UnicamBase->u_ReceiveBuffer;
-    startAddress += UnicamBase->u_Offset.x * (UnicamBase->u_BPP / 8);
-    startAddress += UnicamBase->u_Offset.y * UnicamBase->u_FullSize.width * (UnicamBase->u_BPP / 8);
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+    volatile ULONG *plane = &dlist[offset];
+    BOOL live = plane == UnicamBase->u_DLPlane;
 
-    if (unity)
-    {
-        /* Unity scaling is simple, reserve less space for display list */
-        cnt -= 16;
-
-        UnicamBase->u_UnicamDL = cnt;
-
-        /* Set control reg */
-        ULONG control = 
-            VC6_CONTROL_VALID
-            | VC6_CONTROL_WORDS(8)
-            | VC6_CONTROL_UNITY
-            | VC6_CONTROL_ALPHA_EXPAND
-            | VC6_CONTROL_RGB_EXPAND;
-        
-        if (UnicamBase->u_PixelOrder == 0)
-            control |= VC6_CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XRGB);
-        else
-            control |= VC6_CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XBGR);
+    if (live)
+        Disable();
 
-        if (UnicamBase->u_BPP == 16)
-            control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_RGB565);
-        else if (UnicamBase->u_BPP == 24)
-            control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_RGB888);
+    copy_to_hvs(plane, buf, UnicamBase->u_DLCacheWords);
+    MMIO_WRITE(UnicamBase, UnicamBase->u_DLCacheWords);
 
-        wr32le(&displist[cnt++], control);
+    UnicamBase->u_DLLastPlane = plane;
+    UnicamBase->u_DLLastAddress = &plane[UnicamBase->u_DLCacheAddress];
 
-        /* Center it on the screen */
-        wr32le(&displist[cnt++], VC6_POS0_X(offset_x) | VC6_POS0_Y(offset_y));
-        wr32le(&displist[cnt++], (VC6_SCALER_POS2_ALPHA_MODE_FIXED << VC6_SCALER_POS2_ALPHA_MODE_SHIFT) | VC6_SCALER_POS2_ALPHA(0xfff));
-        wr32le(&displist[cnt++], VC6_POS2_H(UnicamBase->u_Size.height) | VC6_POS2_W(UnicamBase->u_Size.width));
-        wr32le(&displist[cnt++], 0xdeadbeef);
+    if (live)
+    {
+        UnicamBase->u_DLAddressWord = UnicamBase->u_DLLastAddress;
+        Enable();
+    }
 
-        /* Set address */
-        wr32le(&displist[cnt++], 0xc0000000 | startAddress);
-        wr32le(&displist[cnt++], 0xdeadbeef);
+    return UnicamBase->u_DLCachePlane;
+}
 
-        /* Pitch is full width, always */
-        wr32le(&displist[cnt++], UnicamBase->u_FullSize.width * (UnicamBase->u_BPP / 8));
+static void emit_filter(struct UnicamBase *UnicamBase, UBYTE filter, ULONG *buf)
+{
+    if (filter == UNICAM_FILTER_MITCHELL)
+    {
+        LONG kernel_b = (UnicamBase->u_KernelB * 256) / 1000;
+        LONG kernel_c = (UnicamBase->u_KernelC * 256) / 1000;
 
-        /* Done */
-        wr32le(&displist[cnt++], 0x80000000);
+        compute_scaling_kernel(buf, kernel_b, kernel_c);
     }
     else
     {
-        cnt -= 24;
-        
-        UnicamBase->u_UnicamDL = cnt;
-
-        /* Set control reg */
-        ULONG control = 
-            VC6_CONTROL_VALID
-            | VC6_CONTROL_WORDS(17)
-            | VC6_CONTROL_ALPHA_EXPAND
-            | VC6_CONTROL_RGB_EXPAND;
-        
-        if (UnicamBase->u_PixelOrder == 0)
-            control |= VC6_CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XRGB);
-        else
-            control |= VC6_CONTROL_PIXEL_ORDER(HVS_PIXEL_ORDER_XBGR);
+        compute_filter_kernel(buf, filter);
+    }
+}
 
-        if (UnicamBase->u_BPP == 16)
-            control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_RGB565);
-        else if (UnicamBase->u_BPP == 24)
-            control |= CONTROL_FORMAT(HVS_PIXEL_FORMAT_RGB888);
+/* Horizontal kernel followed by the vertical one if it differs, in host byte order. Returns number of words */
+ULONG unicam_emit_kernel(struct UnicamBase *UnicamBase, ULONG *buf)
+{
+    UBYTE filter_h = resolve_filter(UnicamBase, UnicamBase->u_FilterH);
+    UBYTE filter_v = resolve_filter(UnicamBase, UnicamBase->u_FilterV);
 
-        wr32le(&displist[cnt++], control);
+    emit_filter(UnicamBase, filter_h, buf);
 
-        /* Center plane on the screen */
-        wr32le(&displist[cnt++], VC6_POS0_X(offset_x) | VC6_POS0_Y(offset_y));
-        wr32le(&displist[cnt++], (VC6_SCALER_POS2_ALPHA_MODE_FIXED << VC6_SCALER_POS2_ALPHA_MODE_SHIFT) | VC6_SCALER_POS2_ALPHA(0xfff));
-        wr32le(&displist[cnt++], VC6_POS1_H(calc_height) | VC6_POS1_W(calc_width));
-        wr32le(&displist[cnt++], VC6_POS2_H(UnicamBase->u_Size.height) | VC6_POS2_W(UnicamBase->u_Size.width));
-        wr32le(&displist[cnt++], 0xdeadbeef); // Scratch written by HVS
+    if (filter_h == filter_v)
+        return DL_KERNEL_WORDS;
 
-        /* Set address and pitch */
-        wr32le(&displist[cnt++], 0xc0000000 | startAddress);
-        wr32le(&displist[cnt++], 0xdeadbeef);
+    emit_filter(UnicamBase, filter_v, &buf[DL_KERNEL_WORDS]);
 
-        /* Pitch is full width, always */
-        wr32le(&displist[cnt++], UnicamBase->u_FullSize.width * (UnicamBase->u_BPP / 8));
+    return 2 * DL_KERNEL_WORDS;
+}
 
-        /* LMB address */
-        wr32le(&displist[cnt++], 0);
+void unicam_write_kernel(struct UnicamBase *UnicamBase, volatile ULONG *dlist)
+{
+    ULONG buf[2 * DL_KERNEL_WORDS];
+    ULONG count = unicam_emit_kernel(UnicamBase, buf);
 
-        /* Set PPF Scaler */
-        wr32le(&displist[cnt++], (scale_x << 8) | ((ULONG)UnicamBase->u_Scaler << 30) | UnicamBase->u_Phase);
-        wr32le(&displist[cnt++], (scale_y << 8) | ((ULONG)UnicamBase->u_Scaler << 30) | UnicamBase->u_Phase);
-        wr32le(&displist[cnt++], 0); // Scratch written by HVS
+    copy_to_hvs(dlist, buf, count);
+    MMIO_WRITE(UnicamBase, count);
+}
 
-        wr32le(&displist[cnt++], kernel);
-        wr32le(&displist[cnt++], kernel);
-        wr32le(&displist[cnt++], kernel);
-        wr32le(&displist[cnt++], kernel);
+/*
+    Unicam DisplayList, placed in HVS context memory just below 0x300. The resource owns it, so it is
+    registered for buffer flips right away.
+*/
+void ConstructUnicamDL(struct UnicamBase *UnicamBase, ULONG kernel)
+{
+    BOOL vc6 = UnicamBase->u_IsVC6 ? TRUE : FALSE;
+    struct PlaneGeometry geo;
+    volatile ULONG *displist = (ULONG *)((ULONG)UnicamBase->u_PeriphBase + (vc6 ? 0x00404000 : 0x00402000));
 
-        /* Done */
-        wr32le(&displist[cnt++], 0x80000000);
-    }
+    compute_geometry(UnicamBase, &geo);
+
+    UnicamBase->u_UnicamDL = 0x300 - hvs_reserve[vc6][geo.unity];
+    UnicamBase->u_DLPlane = &displist[UnicamBase->u_UnicamDL];
+
+    unicam_write_dl(UnicamBase, displist, UnicamBase->u_UnicamDL, kernel, FALSE);
 }
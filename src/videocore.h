@@ -85,6 +85,11 @@ enum palette_type {
 #define HVS_PIXEL_ORDER_YXCBCR			        2
 #define HVS_PIXEL_ORDER_YXCRCB			        3
 
+/* Colour space converter, ITU-R BT.601 limited range YCbCr to RGB */
+#define SCALER_CSC0_ITR_R_601_5                 0x00f00000
+#define SCALER_CSC1_ITR_R_601_5                 0xe73304a8
+#define SCALER_CSC2_ITR_R_601_5                 0x00066204
+
 #define SCALER_CTL0_SCL_H_PPF_V_PPF             0
 #define SCALER_CTL0_SCL_H_TPZ_V_PPF             1
 #define SCALER_CTL0_SCL_H_PPF_V_TPZ             2
@@ -136,7 +141,11 @@ enum palette_type {
 #define VC6_SCALER_POS2_WIDTH_SHIFT                 0
 
 
-void VC4_ConstructUnicamDL(struct UnicamBase *UnicamBase, ULONG kernel);
-void VC6_ConstructUnicamDL(struct UnicamBase *UnicamBase, ULONG kernel);
+ULONG unicam_dl_size(struct UnicamBase *UnicamBase);
+ULONG unicam_write_dl(struct UnicamBase *UnicamBase, volatile ULONG *dlist, ULONG offset, ULONG kernel, BOOL kernel_after);
+ULONG unicam_kernel_size(struct UnicamBase *UnicamBase);
+ULONG unicam_emit_kernel(struct UnicamBase *UnicamBase, ULONG *buf);
+void unicam_write_kernel(struct UnicamBase *UnicamBase, volatile ULONG *dlist);
+void ConstructUnicamDL(struct UnicamBase *UnicamBase, ULONG kernel);
 
 #endif /* _VIDEOCORE_H */
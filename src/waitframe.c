@@ -0,0 +1,63 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+#include <common/compiler.h>
+
+#include <proto/exec.h>
+
+#include "unicam.h"
+
+/*
+    Wait for the next frame end and return the frame sequence number. Returns at once if capture
+    is not running, UNICAM_WAIT_TIMEOUT if no frame ended within a few frame periods.
+*/
+ULONG L_UnicamWaitFrame(REGARG(struct UnicamBase * UnicamBase, "a6"))
+{
+    struct ExecBase *SysBase = UnicamBase->u_SysBase;
+    struct FrameWaiter waiter;
+
+    /* Nothing to wait for if capture is not running */
+    if (!UnicamBase->u_Running)
+        return UnicamBase->u_FrameSequence;
+
+    waiter.fw_Task = FindTask(NULL);
+    waiter.fw_Signal = AllocSignal(-1);
+    waiter.fw_TimedOut = FALSE;
+
+    if (waiter.fw_Signal < 0)
+        return UnicamBase->u_FrameSequence;
+
+    SetSignal(0, 1UL << waiter.fw_Signal);
+
+    Disable();
+
+    /* Capture could have been stopped in the meantime */
+    if (!UnicamBase->u_Running)
+    {
+        Enable();
+        FreeSignal(waiter.fw_Signal);
+        return UnicamBase->u_FrameSequence;
+    }
+
+    waiter.fw_Start = systimer_read();
+    AddTail((struct List *)&UnicamBase->u_FrameWaiters, (struct Node *)&waiter);
+    Enable();
+
+    Wait(1UL << waiter.fw_Signal);
+
+    FreeSignal(waiter.fw_Signal);
+
+    return waiter.fw_TimedOut ? UNICAM_WAIT_TIMEOUT : UnicamBase->u_FrameSequence;
+}
+
+ULONG L_UnicamGetFrameSequence(REGARG(struct UnicamBase * UnicamBase, "a6"))
+{
+    return UnicamBase->u_FrameSequence;
+}
@@ -0,0 +1,252 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <exec/types.h>
+#include <exec/memory.h>
+#include <graphics/gfx.h>
+
+#include <proto/exec.h>
+
+#include "unicam.h"
+#include "smoothing.h"
+#include "rga_host.h"
+#include "host.h"
+
+/*
+    Time per call of the code paths which run per frame or per setting change. Host timings do not
+    translate to the 68040, compare them between revisions only. Argument is the iteration count,
+    frame grabs move a whole frame per call and run a hundredth of it.
+*/
+static ULONG iterations = 100000;
+static volatile ULONG sink;
+
+static void report(const char *name, ULONG start)
+{
+    ULONG elapsed = host_time_us() - start;
+
+    printf("%-28s %10.1f ns/call\n", name, elapsed * 1000.0 / iterations);
+}
+
+static ULONG frame_iterations(void)
+{
+    return iterations >= 100 ? iterations / 100 : 1;
+}
+
+static void report_rate(const char *name, ULONG start, ULONG bytes)
+{
+    ULONG elapsed = host_time_us() - start;
+
+    printf("%-28s %10.1f MB/s\n", name, elapsed ? (double)bytes * frame_iterations() / elapsed : 0.0);
+}
+
+/* Stopped capture into a single buffer, grabs do not wait for a frame then */
+static UBYTE *setup_capture(struct UnicamBase *UnicamBase, UBYTE bpp, UWORD width, UWORD height, UBYTE align)
+{
+    static UBYTE *buffer;
+
+    if (buffer == NULL)
+        buffer = AllocMem(2048 * 4 * 1080, MEMF_CLEAR);
+
+    UnicamBase->u_Running = FALSE;
+    UnicamBase->u_Mode = bpp == 24 ? CSI_DT_RGB888 : 0;
+    UnicamBase->u_BPP = bpp;
+    UnicamBase->u_PixelOrder = 0;
+    UnicamBase->u_FullSize.width = width;
+    UnicamBase->u_FullSize.height = height;
+    UnicamBase->u_Size = UnicamBase->u_FullSize;
+    UnicamBase->u_Offset.x = 0;
+    UnicamBase->u_Offset.y = 0;
+    UnicamBase->u_Window = FALSE;
+    UnicamBase->u_StrideAlign = align;
+    UnicamBase->u_ActiveBuffers = 1;
+    UnicamBase->u_DisplayBuffer = 0;
+    UnicamBase->u_Buffers[0] = buffer;
+
+    return buffer;
+}
+
+static void bench_constructdl(struct UnicamBase *UnicamBase, ULONG *dlist)
+{
+    ULONG start = host_time_us();
+
+    for (ULONG i = 0; i < iterations; i++)
+        sink += L_UnicamConstructDL(dlist, 0x40, UnicamBase);
+
+    report("ConstructDL cached", start);
+
+    start = host_time_us();
+
+    for (ULONG i = 0; i < iterations; i++)
+    {
+        UnicamBase->u_Generation++;
+        sink += L_UnicamConstructDL(dlist, 0x40, UnicamBase);
+    }
+
+    report("ConstructDL rebuilt", start);
+}
+
+static void bench_kernels(void)
+{
+    ULONG kernel[DL_KERNEL_WORDS];
+    ULONG start = host_time_us();
+
+    for (ULONG i = 0; i < iterations; i++)
+    {
+        compute_scaling_kernel(kernel, 64 + (i & 63), 192);
+        sink += kernel[0];
+    }
+
+    report("Mitchell kernel", start);
+
+    start = host_time_us();
+
+    for (ULONG i = 0; i < iterations; i++)
+    {
+        compute_filter_kernel(kernel, UNICAM_FILTER_NEAREST + i % (UNICAM_FILTER_COUNT - 1));
+        sink += kernel[0];
+    }
+
+    report("Fixed filter kernel", start);
+}
+
+static void bench_rga(void)
+{
+    uint16_t tx[RGA_MAX_FRAME];
+    ULONG start = host_time_us();
+
+    for (ULONG i = 0; i < iterations; i++)
+    {
+        sink += rga_encode_cmd(tx, FTCMD_WRITE, i, (uint16_t)i);
+        sink += tx[5];
+    }
+
+    report("RGA frame encode", start);
+}
+
+/*
+    Straight copy of an odd sized frame: packed lines of 2142 bytes start anywhere, 64 byte stride
+    keeps every line aligned and the copy goes by longwords (MOVE16 on the 68040).
+*/
+static void bench_stride(struct UnicamBase *UnicamBase)
+{
+    UBYTE *dest = AllocMem(2176 * 576, MEMF_ANY);
+    static const UBYTE aligns[] = { 0, 64 };
+
+    for (int i = 0; i < 2; i++)
+    {
+        char name[32];
+
+        setup_capture(UnicamBase, 24, 714, 576, aligns[i]);
+        snprintf(name, sizeof(name), "Grab copy, stride %u", unicam_stride(UnicamBase));
+
+        ULONG start = host_time_us();
+
+        for (ULONG n = 0; n < frame_iterations(); n++)
+            sink += L_UnicamGrabFrame(dest, UNICAM_GRAB_BGR24, NULL, UnicamBase);
+
+        report_rate(name, start, 714 * 3 * 576);
+    }
+
+    FreeMem(dest, 2176 * 576);
+}
+
+/* Conversion of a 720x576 frame from RGB888 and RGB565 capture into every grab format */
+static void bench_convert(struct UnicamBase *UnicamBase)
+{
+    static const char *const names[UNICAM_GRAB_COUNT] = { "RGB24", "BGR24", "ARGB32", "BGRA32", "RGB16", "RGB16PC" };
+    static const UBYTE grab_bpp[UNICAM_GRAB_COUNT] = { 3, 3, 4, 4, 2, 2 };
+    UBYTE *dest = AllocMem(720 * 576 * 4, MEMF_ANY);
+
+    for (UBYTE bpp = 24; bpp >= 16; bpp -= 8)
+    {
+        for (ULONG format = 0; format < UNICAM_GRAB_COUNT; format++)
+        {
+            char name[32];
+
+            setup_capture(UnicamBase, bpp, 720, 576, 64);
+            snprintf(name, sizeof(name), "Grab %s to %s", bpp == 24 ? "RGB888" : "RGB565", names[format]);
+
+            ULONG start = host_time_us();
+
+            for (ULONG n = 0; n < frame_iterations(); n++)
+                sink += L_UnicamGrabFrame(dest, format, NULL, UnicamBase);
+
+            report_rate(name, start, 720 * 576 * grab_bpp[format]);
+        }
+    }
+
+    FreeMem(dest, 720 * 576 * 4);
+}
+
+/* UnicamGrabPlanar() of a 720x576 capture into 320x256 bitmaps, rate in plane bytes written */
+static void bench_c2p(struct UnicamBase *UnicamBase)
+{
+    struct BitMap bm;
+
+    memset(&bm, 0, sizeof(bm));
+    bm.BytesPerRow = 40;
+    bm.Rows = 256;
+
+    for (bm.Depth = 4; bm.Depth <= 8; bm.Depth += 4)
+    {
+        for (int p = 0; p < bm.Depth; p++)
+            bm.Planes[p] = AllocMem(40 * 256, MEMF_CLEAR);
+
+        for (int grey = 0; grey < 2; grey++)
+        {
+            char name[32];
+            ULONG flags = UNICAM_PLANARF_NOWAIT | (grey ? UNICAM_PLANARF_GREY : 0);
+
+            setup_capture(UnicamBase, 24, 720, 576, 64);
+            snprintf(name, sizeof(name), "GrabPlanar %d planes%s", bm.Depth, grey ? " grey" : "");
+
+            ULONG start = host_time_us();
+
+            for (ULONG n = 0; n < frame_iterations(); n++)
+                sink += L_UnicamGrabPlanar(&bm, NULL, NULL, flags, 320, UnicamBase);
+
+            report_rate(name, start, 40 * 256 * bm.Depth);
+        }
+
+        for (int p = 0; p < bm.Depth; p++)
+            FreeMem(bm.Planes[p], 40 * 256);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    struct UnicamBase *UnicamBase = host_unicam_base();
+    ULONG *dlist = AllocMem(0x100 * sizeof(ULONG), MEMF_CLEAR);
+
+    if (argc > 1)
+        iterations = strtoul(argv[1], NULL, 0);
+    if (iterations == 0)
+        iterations = 1;
+
+    UnicamBase->u_Mode = CSI_DT_RGB888;
+    UnicamBase->u_BPP = 24;
+    UnicamBase->u_FullSize.width = 720;
+    UnicamBase->u_FullSize.height = 576;
+    UnicamBase->u_Size = UnicamBase->u_FullSize;
+    UnicamBase->u_Smooth = 1;
+    UnicamBase->u_ReceiveBuffer = (APTR)0x1e000000;
+
+    bench_constructdl(UnicamBase, dlist);
+    bench_kernels();
+    bench_rga();
+    bench_stride(UnicamBase);
+    bench_convert(UnicamBase);
+    bench_c2p(UnicamBase);
+
+    return 0;
+}
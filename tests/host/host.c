@@ -0,0 +1,445 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#include <exec/types.h>
+#include <exec/memory.h>
+#include <proto/exec.h>
+
+#include "unicam.h"
+#include "host.h"
+
+const char deviceName[] = "unicam.resource";
+
+static struct ExecBase host_exec;
+static struct Task host_task;
+static UBYTE *arena_next;
+static int failures;
+
+struct ExecBase *HostSysBase = &host_exec;
+void (*host_idle_hook)(void);
+
+void host_init(void)
+{
+    if (arena_next != NULL)
+        return;
+
+    void *arena = mmap((void *)HOST_ARENA_BASE, HOST_ARENA_SIZE, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if (arena != (void *)HOST_ARENA_BASE)
+    {
+        fprintf(stderr, "Cannot map host arena at %08x\n", HOST_ARENA_BASE);
+        exit(2);
+    }
+
+    arena_next = arena;
+    host_task.tc_SigAlloc = 0xffff;     // Signals reserved by the system
+}
+
+/* Arena memory is never reused, AllocMem() only bumps the pointer. Tests allocate little */
+APTR AllocMem(ULONG size, ULONG flags)
+{
+    host_init();
+
+    UBYTE *block = arena_next;
+    ULONG aligned = (size + 7) & ~7;
+
+    if (block + aligned > (UBYTE *)HOST_ARENA_BASE + HOST_ARENA_SIZE)
+        return NULL;
+
+    arena_next += aligned;
+
+    if (flags & MEMF_CLEAR)
+        memset(block, 0, size);
+    else
+        memset(block, 0xa5, size);
+
+    return block;
+}
+
+void FreeMem(APTR memory, ULONG size)
+{
+    memset(memory, 0x5a, size);
+}
+
+void Disable(void) { }
+void Enable(void) { }
+void Forbid(void) { }
+void Permit(void) { }
+
+/* Only the host task ever takes a semaphore, nesting is counted so that tests can check balance */
+void InitSemaphore(struct SignalSemaphore *semaphore)
+{
+    semaphore->ss_NestCount = 0;
+    semaphore->ss_Owner = NULL;
+}
+
+void ObtainSemaphore(struct SignalSemaphore *semaphore)
+{
+    semaphore->ss_NestCount++;
+    semaphore->ss_Owner = &host_task;
+}
+
+void ReleaseSemaphore(struct SignalSemaphore *semaphore)
+{
+    if (semaphore->ss_NestCount <= 0)
+    {
+        fprintf(stderr, "ReleaseSemaphore() without ObtainSemaphore()\n");
+        abort();
+    }
+
+    if (--semaphore->ss_NestCount == 0)
+        semaphore->ss_Owner = NULL;
+}
+
+#define HOST_MAX_SERVERS    4
+
+static struct Interrupt *servers[HOST_MAX_SERVERS];
+
+void AddIntServer(LONG intNum, struct Interrupt *interrupt)
+{
+    (void)intNum;
+
+    for (int i = 0; i < HOST_MAX_SERVERS; i++)
+    {
+        if (servers[i] == NULL)
+        {
+            servers[i] = interrupt;
+            return;
+        }
+    }
+
+    fprintf(stderr, "Too many interrupt servers\n");
+    abort();
+}
+
+void RemIntServer(LONG intNum, struct Interrupt *interrupt)
+{
+    (void)intNum;
+
+    for (int i = 0; i < HOST_MAX_SERVERS; i++)
+    {
+        if (servers[i] == interrupt)
+            servers[i] = NULL;
+    }
+}
+
+/* Vertical blank: call all servers with their data as the a1 argument */
+void host_run_vblank(void)
+{
+    for (int i = 0; i < HOST_MAX_SERVERS; i++)
+    {
+        if (servers[i] != NULL)
+            ((ULONG (*)(APTR))servers[i]->is_Code)(servers[i]->is_Data);
+    }
+}
+
+int host_int_servers(void)
+{
+    int count = 0;
+
+    for (int i = 0; i < HOST_MAX_SERVERS; i++)
+        count += servers[i] != NULL;
+
+    return count;
+}
+
+struct Task *FindTask(CONST_STRPTR name)
+{
+    return name == NULL ? &host_task : NULL;
+}
+
+BYTE AllocSignal(LONG signalNum)
+{
+    for (int i = 31; i >= 0; i--)
+    {
+        if (!(host_task.tc_SigAlloc & (1UL << i)) && (signalNum < 0 || signalNum == i))
+        {
+            host_task.tc_SigAlloc |= 1UL << i;
+            host_task.tc_SigRecvd &= ~(1UL << i);
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void FreeSignal(LONG signalNum)
+{
+    if (signalNum >= 0)
+        host_task.tc_SigAlloc &= ~(1UL << signalNum);
+}
+
+ULONG SetSignal(ULONG newSignals, ULONG signalMask)
+{
+    ULONG old = host_task.tc_SigRecvd;
+
+    host_task.tc_SigRecvd = (old & ~signalMask) | (newSignals & signalMask);
+
+    return old;
+}
+
+void Signal(struct Task *task, ULONG signals)
+{
+    task->tc_SigRecvd |= signals;
+}
+
+/*
+    There is a single task on the host. While it waits, the idle hook stands in for everything else
+    that would run: the simulator advances time by a frame and calls interrupt servers. A wait which
+    is not satisfied after many idle rounds is a hang of the code under test.
+*/
+ULONG Wait(ULONG signals)
+{
+    for (int round = 0; !(host_task.tc_SigRecvd & signals); round++)
+    {
+        if (host_idle_hook == NULL || round > 10000)
+        {
+            fprintf(stderr, "Wait(%08x) never returns\n", signals);
+            abort();
+        }
+
+        host_idle_hook();
+    }
+
+    ULONG received = host_task.tc_SigRecvd & signals;
+    host_task.tc_SigRecvd &= ~signals;
+
+    return received;
+}
+
+void AddTail(struct List *list, struct Node *node)
+{
+    node->ln_Succ = (struct Node *)&list->lh_Tail;
+    node->ln_Pred = list->lh_TailPred;
+    list->lh_TailPred->ln_Succ = node;
+    list->lh_TailPred = node;
+}
+
+void Remove(struct Node *node)
+{
+    node->ln_Pred->ln_Succ = node->ln_Succ;
+    node->ln_Succ->ln_Pred = node->ln_Pred;
+}
+
+APTR AddTask(struct Task *task, APTR initialPC, APTR finalPC)
+{
+    (void)initialPC;
+    (void)finalPC;
+
+    return task;
+}
+
+struct Library *OpenLibrary(CONST_STRPTR name, ULONG version)
+{
+    (void)name;
+    (void)version;
+
+    return NULL;
+}
+
+void CloseLibrary(struct Library *library)
+{
+    (void)library;
+}
+
+/* Minimal RawDoFmt(): arguments are an array of ULONG, only the formats used by the resource */
+void kprintf(const char *msg, void *args)
+{
+    const ULONG *arg = args;
+
+    if (getenv("UNICAM_HOST_VERBOSE") == NULL)
+        return;
+
+    for (const char *p = msg; *p; p++)
+    {
+        if (*p != '%')
+        {
+            fputc(*p, stderr);
+            continue;
+        }
+
+        char spec[16];
+        int n = 0;
+
+        spec[n++] = *p++;
+        while (*p && strchr("0123456789-l", *p) && n < 12)
+        {
+            if (*p != 'l')
+                spec[n++] = *p;
+            p++;
+        }
+
+        if (*p == 's')
+        {
+            fprintf(stderr, "%s", (const char *)(uintptr_t)*arg++);
+        }
+        else if (*p == 'd' || *p == 'u' || *p == 'x' || *p == 'X' || *p == 'c')
+        {
+            spec[n++] = *p;
+            spec[n] = 0;
+            fprintf(stderr, spec, *p == 'd' ? (int)*arg : *arg);
+            arg++;
+        }
+        else if (*p == '%')
+        {
+            fputc('%', stderr);
+        }
+        else if (*p == 0)
+        {
+            break;
+        }
+    }
+}
+
+/* UnicamBase as Init() sets it up before the devicetree is read */
+struct UnicamBase *host_unicam_base(void)
+{
+    struct UnicamBase *UnicamBase = AllocMem(sizeof(struct UnicamBase), MEMF_PUBLIC | MEMF_CLEAR);
+
+    UnicamBase->u_SysBase = HostSysBase;
+    UnicamBase->u_Phase = 64;
+    UnicamBase->u_Scaler = 3;
+    UnicamBase->u_KernelB = 250;
+    UnicamBase->u_KernelC = 750;
+    UnicamBase->u_Aspect = 1000;
+    UnicamBase->u_BufferCount = 1;
+    UnicamBase->u_Lanes = 1;
+    UnicamBase->u_Generation = 1;
+    UnicamBase->u_DisplaySize.width = 1920;
+    UnicamBase->u_DisplaySize.height = 1080;
+    InitSemaphore(&UnicamBase->u_Lock);
+
+    return UnicamBase;
+}
+
+ULONG host_time_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int host_check(int condition, const char *what, const char *file, int line)
+{
+    if (!condition)
+    {
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+        failures++;
+    }
+
+    return condition;
+}
+
+int host_failures(void)
+{
+    if (failures)
+        fprintf(stderr, "%d check(s) failed\n", failures);
+
+    return failures != 0;
+}
+
+/*
+    Compare output with the golden file. With UNICAM_UPDATE_GOLDEN set in the environment the file
+    is written instead, the change then shows up in the diff of the commit.
+*/
+int host_golden(const char *path, const char *text, ULONG length)
+{
+    if (getenv("UNICAM_UPDATE_GOLDEN") != NULL)
+    {
+        FILE *f = fopen(path, "w");
+
+        if (f == NULL || fwrite(text, 1, length, f) != length)
+        {
+            fprintf(stderr, "Cannot write %s\n", path);
+            failures++;
+        }
+        if (f)
+            fclose(f);
+
+        return 1;
+    }
+
+    FILE *f = fopen(path, "r");
+
+    if (f == NULL)
+    {
+        fprintf(stderr, "Cannot read %s\n", path);
+        failures++;
+        return 0;
+    }
+
+    char *golden = malloc(length + 1);
+    size_t got = fread(golden, 1, length + 1, f);
+    fclose(f);
+
+    if (got == length && memcmp(golden, text, length) == 0)
+    {
+        free(golden);
+        return 1;
+    }
+
+    ULONG line = 1;
+    ULONG i;
+
+    for (i = 0; i < length && i < got && golden[i] == text[i]; i++)
+    {
+        if (text[i] == '\n')
+            line++;
+    }
+
+    fprintf(stderr, "%s differs from output at line %u\n", path, line);
+    free(golden);
+    failures++;
+
+    return 0;
+}
+
+static char text[1 << 20];
+static ULONG text_length;
+
+void host_text(const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    int n = vsnprintf(&text[text_length], sizeof(text) - text_length, format, args);
+    va_end(args);
+
+    if (n < 0 || text_length + n >= sizeof(text))
+    {
+        fprintf(stderr, "Golden output too long\n");
+        abort();
+    }
+
+    text_length += n;
+}
+
+/* Compare the collected text with GOLDEN_DIR/name and start over */
+int host_golden_text(const char *name)
+{
+    char path[512];
+
+    snprintf(path, sizeof(path), "%s/%s", GOLDEN_DIR, name);
+
+    int result = host_golden(path, text, text_length);
+    text_length = 0;
+
+    return result;
+}
@@ -0,0 +1,48 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef _HOST_H
+#define _HOST_H
+
+#include <exec/types.h>
+#include <exec/execbase.h>
+
+#include "unicam.h"
+
+/*
+    The resource keeps addresses in ULONG, so everything it gets to see has to be addressable with
+    32 bits. Memory of the host build comes from an arena mapped at a fixed address below 1GB, which
+    also keeps bus addresses (0xC0000000 | address) meaningful.
+*/
+#define HOST_ARENA_BASE     0x20000000
+#define HOST_ARENA_SIZE     0x10000000
+
+extern struct ExecBase *HostSysBase;
+
+/* Called by Wait() until the signals arrive, the simulator advances time and delivers frames */
+extern void (*host_idle_hook)(void);
+
+void host_init(void);
+struct UnicamBase *host_unicam_base(void);
+void host_run_vblank(void);
+int host_int_servers(void);
+
+/* Test helpers */
+ULONG host_time_us(void);
+int host_check(int condition, const char *what, const char *file, int line);
+int host_failures(void);
+int host_golden(const char *path, const char *text, ULONG length);
+
+/* Output collected for host_golden_text() */
+void host_text(const char *format, ...) __attribute__((format(printf, 1, 2)));
+int host_golden_text(const char *name);
+
+#define CHECK(cond) host_check((cond) != 0, #cond, __FILE__, __LINE__)
+
+#endif /* _HOST_H */
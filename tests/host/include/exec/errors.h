@@ -0,0 +1,6 @@
+#ifndef EXEC_ERRORS_H
+#define EXEC_ERRORS_H
+
+#include <exec/execbase.h>
+
+#endif /* EXEC_ERRORS_H */
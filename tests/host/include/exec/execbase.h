@@ -0,0 +1,13 @@
+#ifndef EXEC_EXECBASE_H
+#define EXEC_EXECBASE_H
+
+#include <exec/libraries.h>
+#include <exec/tasks.h>
+#include <exec/interrupts.h>
+
+struct ExecBase {
+    struct Library  LibNode;
+    UWORD           AttnFlags;
+};
+
+#endif /* EXEC_EXECBASE_H */
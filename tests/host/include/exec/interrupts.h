@@ -0,0 +1,12 @@
+#ifndef EXEC_INTERRUPTS_H
+#define EXEC_INTERRUPTS_H
+
+#include <exec/nodes.h>
+
+struct Interrupt {
+    struct Node     is_Node;
+    APTR            is_Data;
+    void            (*is_Code)();
+};
+
+#endif /* EXEC_INTERRUPTS_H */
@@ -0,0 +1,6 @@
+#ifndef EXEC_IO_H
+#define EXEC_IO_H
+
+#include <exec/execbase.h>
+
+#endif /* EXEC_IO_H */
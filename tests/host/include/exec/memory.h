@@ -0,0 +1,12 @@
+#ifndef EXEC_MEMORY_H
+#define EXEC_MEMORY_H
+
+#include <exec/types.h>
+
+#define MEMF_ANY        0
+#define MEMF_PUBLIC     (1 << 0)
+#define MEMF_CHIP       (1 << 1)
+#define MEMF_FAST       (1 << 2)
+#define MEMF_CLEAR      (1 << 16)
+
+#endif /* EXEC_MEMORY_H */
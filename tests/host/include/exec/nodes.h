@@ -0,0 +1,24 @@
+#ifndef EXEC_NODES_H
+#define EXEC_NODES_H
+
+#include <exec/types.h>
+
+struct Node {
+    struct Node *   ln_Succ;
+    struct Node *   ln_Pred;
+    UBYTE           ln_Type;
+    BYTE            ln_Pri;
+    char *          ln_Name;
+};
+
+struct MinNode {
+    struct MinNode *mln_Succ;
+    struct MinNode *mln_Pred;
+};
+
+#define NT_TASK         1
+#define NT_INTERRUPT    2
+#define NT_LIBRARY      9
+#define NT_RESOURCE     8
+
+#endif /* EXEC_NODES_H */
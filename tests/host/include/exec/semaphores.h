@@ -0,0 +1,13 @@
+#ifndef EXEC_SEMAPHORES_H
+#define EXEC_SEMAPHORES_H
+
+#include <exec/nodes.h>
+#include <exec/tasks.h>
+
+struct SignalSemaphore {
+    struct Node     ss_Link;
+    WORD            ss_NestCount;
+    struct Task *   ss_Owner;
+};
+
+#endif /* EXEC_SEMAPHORES_H */
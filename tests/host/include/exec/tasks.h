@@ -0,0 +1,23 @@
+#ifndef EXEC_TASKS_H
+#define EXEC_TASKS_H
+
+#include <exec/lists.h>
+
+struct Task {
+    struct Node     tc_Node;
+    UBYTE           tc_Flags;
+    UBYTE           tc_State;
+    BYTE            tc_IDNestCnt;
+    BYTE            tc_TDNestCnt;
+    ULONG           tc_SigAlloc;
+    ULONG           tc_SigWait;
+    ULONG           tc_SigRecvd;
+    ULONG           tc_SigExcept;
+    APTR            tc_SPReg;
+    APTR            tc_SPLower;
+    APTR            tc_SPUpper;
+    struct List     tc_MemEntry;
+    APTR            tc_UserData;
+};
+
+#endif /* EXEC_TASKS_H */
@@ -0,0 +1,30 @@
+/*
+    Host build shim of exec/types.h. Sizes follow the m68k ABI, pointers stored in ULONG rely on all
+    buffers of the host build living below 4GB, see tests/host/host.c.
+*/
+
+#ifndef EXEC_TYPES_H
+#define EXEC_TYPES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t        ULONG;
+typedef int32_t         LONG;
+typedef uint16_t        UWORD;
+typedef int16_t         WORD;
+typedef uint8_t         UBYTE;
+typedef int8_t          BYTE;
+typedef int16_t         BOOL;
+typedef void *          APTR;
+typedef const void *    CONST_APTR;
+typedef unsigned char * STRPTR;
+typedef const char *    CONST_STRPTR;
+typedef unsigned char * PLANEPTR;
+typedef void            VOID;
+
+#define CONST   const
+#define TRUE    1
+#define FALSE   0
+
+#endif /* EXEC_TYPES_H */
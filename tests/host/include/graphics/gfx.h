@@ -0,0 +1,23 @@
+#ifndef GRAPHICS_GFX_H
+#define GRAPHICS_GFX_H
+
+#include <exec/types.h>
+
+struct BitMap {
+    UWORD           BytesPerRow;
+    UWORD           Rows;
+    UBYTE           Flags;
+    UBYTE           Depth;
+    UWORD           pad;
+    PLANEPTR        Planes[8];
+};
+
+#define BMB_INTERLEAVED 2
+#define BMF_INTERLEAVED (1 << BMB_INTERLEAVED)
+
+#define BMA_HEIGHT      0
+#define BMA_DEPTH       4
+#define BMA_WIDTH       8
+#define BMA_FLAGS       12
+
+#endif /* GRAPHICS_GFX_H */
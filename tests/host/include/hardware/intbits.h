@@ -0,0 +1,6 @@
+#ifndef HARDWARE_INTBITS_H
+#define HARDWARE_INTBITS_H
+
+#define INTB_VERTB  5
+
+#endif /* HARDWARE_INTBITS_H */
@@ -0,0 +1,6 @@
+#ifndef LIBRARIES_CONFIGREGS_H
+#define LIBRARIES_CONFIGREGS_H
+
+#include <exec/types.h>
+
+#endif /* LIBRARIES_CONFIGREGS_H */
@@ -0,0 +1,12 @@
+#ifndef LIBRARIES_CONFIGVARS_H
+#define LIBRARIES_CONFIGVARS_H
+
+#include <exec/types.h>
+
+struct ConfigDev {
+    UBYTE           cd_Flags;
+    APTR            cd_BoardAddr;
+    APTR            cd_Driver;
+};
+
+#endif /* LIBRARIES_CONFIGVARS_H */
@@ -0,0 +1,15 @@
+/* Host build shim of proto/devicetree.h */
+
+#ifndef PROTO_DEVICETREE_H
+#define PROTO_DEVICETREE_H
+
+#include <exec/types.h>
+
+APTR DT_OpenKey(CONST_STRPTR name);
+void DT_CloseKey(APTR key);
+APTR DT_FindProperty(APTR key, CONST_STRPTR property);
+CONST_APTR DT_GetPropValue(APTR property);
+ULONG DT_GetPropLen(APTR property);
+APTR DT_GetParent(APTR key);
+
+#endif /* PROTO_DEVICETREE_H */
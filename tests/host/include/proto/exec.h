@@ -0,0 +1,36 @@
+/*
+    Host build shim of proto/exec.h. Calls do not go through SysBase, they are plain functions
+    implemented in tests/host/host.c.
+*/
+
+#ifndef PROTO_EXEC_H
+#define PROTO_EXEC_H
+
+#include <exec/execbase.h>
+#include <exec/memory.h>
+#include <exec/semaphores.h>
+
+APTR AllocMem(ULONG size, ULONG flags);
+void FreeMem(APTR memory, ULONG size);
+void Disable(void);
+void Enable(void);
+void Forbid(void);
+void Permit(void);
+void InitSemaphore(struct SignalSemaphore *semaphore);
+void ObtainSemaphore(struct SignalSemaphore *semaphore);
+void ReleaseSemaphore(struct SignalSemaphore *semaphore);
+void AddIntServer(LONG intNum, struct Interrupt *interrupt);
+void RemIntServer(LONG intNum, struct Interrupt *interrupt);
+struct Task *FindTask(CONST_STRPTR name);
+BYTE AllocSignal(LONG signalNum);
+void FreeSignal(LONG signalNum);
+ULONG SetSignal(ULONG newSignals, ULONG signalMask);
+void Signal(struct Task *task, ULONG signals);
+ULONG Wait(ULONG signals);
+void AddTail(struct List *list, struct Node *node);
+void Remove(struct Node *node);
+APTR AddTask(struct Task *task, APTR initialPC, APTR finalPC);
+struct Library *OpenLibrary(CONST_STRPTR name, ULONG version);
+void CloseLibrary(struct Library *library);
+
+#endif /* PROTO_EXEC_H */
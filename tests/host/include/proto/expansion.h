@@ -0,0 +1,6 @@
+#ifndef PROTO_EXPANSION_H
+#define PROTO_EXPANSION_H
+
+#include <libraries/configvars.h>
+
+#endif /* PROTO_EXPANSION_H */
@@ -0,0 +1,10 @@
+/* Host build shim of proto/mailbox.h, requests are answered by the simulator */
+
+#ifndef PROTO_MAILBOX_H
+#define PROTO_MAILBOX_H
+
+#include <exec/types.h>
+
+void MB_RawCommand(ULONG *command);
+
+#endif /* PROTO_MAILBOX_H */
@@ -0,0 +1,484 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include <exec/types.h>
+
+#include "unicam.h"
+#include "vc4-regs-unicam.h"
+#include "i2c.h"
+#include "host.h"
+#include "sim.h"
+
+#define CM_PASSWD       (0x5aUL << 24)
+#define CM_ENAB         (1 << 4)
+#define CM_BUSY         (1 << 7)
+
+#define CSI_REGS        (0x800 / 4)
+
+struct SimCounts sim_counts;
+struct SimSource sim_source;
+struct SimI2C sim_i2c;
+
+static ULONG csi[CSI_REGS];
+static ULONG ib_start;          // Image pointers in use by the frame being written
+static ULONG ib_end;
+static ULONG cam1ctl;
+static ULONG cam1div;
+static ULONG clkgate;
+static ULONG now;
+static ULONG frames;
+static BOOL in_frame;
+
+UBYTE sim_pattern(ULONG frame, ULONG x, ULONG y)
+{
+    return frame * 7 + x * 3 + y * 5;
+}
+
+/* Host memory behind a bus address written to the image pointers */
+static UBYTE *bus_to_host(ULONG address)
+{
+    return (UBYTE *)(uintptr_t)(address & ~0xC0000000);
+}
+
+/*
+    Unicam registers. Status bits are cleared by writing ones. LIP takes the image pointers over at
+    once, otherwise they are latched at frame start and used for that frame. Peripheral reset clears
+    everything but CTRL and drops the frame in progress.
+*/
+static void csi_write(ULONG offset, ULONG value)
+{
+    ULONG *reg = &csi[offset / 4];
+
+    sim_counts.sc_CSIWrites++;
+
+    switch (offset)
+    {
+        case UNICAM_CTRL:
+            if (value & UNICAM_CPR)
+            {
+                memset(csi, 0, sizeof(csi));
+                ib_start = ib_end = 0;
+                in_frame = FALSE;
+            }
+            *reg = value;
+            break;
+
+        case UNICAM_STA:
+        case UNICAM_ISTA:
+            *reg &= ~value;
+            break;
+
+        case UNICAM_ICTL:
+            if (value & UNICAM_LIP_MASK)
+            {
+                ib_start = csi[UNICAM_IBSA0 / 4];
+                ib_end = csi[UNICAM_IBEA0 / 4];
+                csi[UNICAM_IBWP / 4] = ib_start;
+            }
+            *reg = value & ~UNICAM_LIP_MASK;
+            break;
+
+        case UNICAM_IBWP:
+            break;
+
+        default:
+            *reg = value;
+            break;
+    }
+}
+
+static ULONG csi_read(ULONG offset)
+{
+    sim_counts.sc_CSIReads++;
+
+    return csi[offset / 4];
+}
+
+ULONG sim_csi_reg(ULONG offset)
+{
+    return csi[offset / 4];
+}
+
+enum { BSC_IDLE, BSC_WRITE, BSC_READ };
+
+static ULONG bsc_status;
+static ULONG bsc_length;
+static ULONG bsc_address;
+static int bsc_transfer;
+static int bsc_polls;
+static UBYTE bsc_tx[0x10000];
+static ULONG bsc_tx_count;
+static UBYTE bsc_rx[0x10000];
+static ULONG bsc_rx_head;
+static ULONG bsc_rx_count;
+static UWORD c790_pointer;
+
+/* Transfer is over: data goes to or comes from the chip, stop is not sent before a repeated start */
+static void bsc_finish(BOOL stop)
+{
+    BOOL ack = sim_i2c.si_Present && bsc_address == SIM_I2C_ADDR;
+
+    if (bsc_transfer == BSC_WRITE)
+    {
+        sim_i2c.si_Writes++;
+
+        if (ack)
+        {
+            ULONG i = 0;
+
+            if (bsc_tx_count >= 2)
+            {
+                c790_pointer = (bsc_tx[0] << 8) | bsc_tx[1];
+                i = 2;
+            }
+
+            if (sim_i2c.si_Trace)
+                host_text("W %04x:", c790_pointer);
+
+            for (; i < bsc_tx_count; i++)
+            {
+                if (sim_i2c.si_Trace)
+                    host_text(" %02x", bsc_tx[i]);
+                sim_i2c.si_Regs[c790_pointer++] = bsc_tx[i];
+            }
+
+            if (sim_i2c.si_Trace)
+                host_text("\n");
+        }
+    }
+    else
+    {
+        sim_i2c.si_Reads++;
+
+        if (ack)
+        {
+            if (sim_i2c.si_Trace)
+                host_text("R %04x: %u bytes\n", c790_pointer, bsc_length);
+
+            for (ULONG i = 0; i < bsc_length; i++)
+                bsc_rx[bsc_rx_count++] = sim_i2c.si_Regs[c790_pointer++];
+        }
+    }
+
+    bsc_tx_count = 0;
+    bsc_transfer = BSC_IDLE;
+    bsc_status &= ~I2C_S_TA;
+
+    if (!ack)
+        bsc_status |= I2C_S_ERR | I2C_S_DONE;
+    else if (stop)
+        bsc_status |= I2C_S_DONE;
+}
+
+/*
+    BSC controller. Writing C without I2CEN abandons the transfer, a start while a write is still
+    active finishes it without stop. Status bits ERR, CLKT and DONE are cleared by writing ones.
+*/
+static void bsc_write(ULONG offset, ULONG value)
+{
+    switch (offset)
+    {
+        case offsetof(tI2cRegs, C):
+            if (value & (I2C_C_CLEAR_FIFO_ONE_SHOT | I2C_C_CLEAR_FIFO_ONE_SHOT2))
+            {
+                bsc_tx_count = 0;
+                bsc_rx_head = bsc_rx_count = 0;
+            }
+            if (!(value & I2C_C_I2CEN))
+            {
+                bsc_transfer = BSC_IDLE;
+                bsc_status &= ~I2C_S_TA;
+                break;
+            }
+            if (value & I2C_C_ST)
+            {
+                int next = (value & I2C_C_READ_PACKET) ? BSC_READ : BSC_WRITE;
+
+                if (bsc_transfer == BSC_WRITE && next == BSC_READ)
+                {
+                    sim_i2c.si_RepeatedStarts++;
+                    bsc_finish(FALSE);
+                }
+
+                bsc_transfer = next;
+                bsc_polls = SIM_I2C_POLLS;
+                bsc_status |= I2C_S_TA;
+            }
+            break;
+
+        case offsetof(tI2cRegs, S):
+            bsc_status &= ~(value & (I2C_S_CLKT | I2C_S_ERR | I2C_S_DONE));
+            break;
+
+        case offsetof(tI2cRegs, DLEN):
+            bsc_length = value & 0xffff;
+            break;
+
+        case offsetof(tI2cRegs, A):
+            bsc_address = value & 0x7f;
+            break;
+
+        case offsetof(tI2cRegs, FIFO):
+            bsc_tx[bsc_tx_count++ & 0xffff] = value;
+            break;
+
+        case offsetof(tI2cRegs, DIV):
+            sim_i2c.si_Div = value & 0xffff;
+            break;
+    }
+}
+
+static ULONG bsc_read(ULONG offset)
+{
+    switch (offset)
+    {
+        case offsetof(tI2cRegs, S):
+        {
+            /* Active transfer moves on with every poll, unless the clock is held low */
+            if (bsc_transfer != BSC_IDLE && !sim_i2c.si_Stall &&
+                (bsc_transfer == BSC_READ || bsc_tx_count >= bsc_length) && --bsc_polls == 0)
+            {
+                bsc_finish(TRUE);
+            }
+
+            ULONG status = bsc_status;
+
+            if (bsc_transfer == BSC_WRITE && bsc_tx_count < bsc_length)
+                status |= I2C_S_TXW;
+            if (bsc_tx_count == 0)
+                status |= I2C_S_TXE;
+            if (bsc_rx_head < bsc_rx_count)
+                status |= I2C_S_RXD;
+
+            return status;
+        }
+
+        case offsetof(tI2cRegs, FIFO):
+            return bsc_rx_head < bsc_rx_count ? bsc_rx[bsc_rx_head++] : 0;
+
+        case offsetof(tI2cRegs, DLEN):
+            return bsc_length;
+
+        case offsetof(tI2cRegs, DIV):
+            return sim_i2c.si_Div;
+    }
+
+    return 0;
+}
+
+/* Clock manager: writes without the password are ignored, BUSY follows ENAB at once */
+static void clock_write(ULONG address, ULONG value)
+{
+    sim_counts.sc_ClockWrites++;
+
+    if ((value & 0xff000000) != CM_PASSWD)
+        return;
+
+    if (address == SIM_CM_CAM1CTL)
+        cam1ctl = value & 0x00ffffff & ~CM_BUSY;
+    else if (address == SIM_CM_CAM1DIV)
+        cam1div = value & 0x00ffffff;
+    else
+        clkgate = value & 0x00ffffff;
+}
+
+static ULONG clock_read(ULONG address)
+{
+    sim_counts.sc_ClockReads++;
+
+    if (address == SIM_CM_CAM1CTL)
+        return CM_PASSWD | cam1ctl | ((cam1ctl & CM_ENAB) ? CM_BUSY : 0);
+    else if (address == SIM_CM_CAM1DIV)
+        return CM_PASSWD | cam1div;
+    else
+        return CM_PASSWD | clkgate;
+}
+
+void host_mmio_write(volatile ULONG *addr, ULONG value)
+{
+    ULONG address = (ULONG)(uintptr_t)addr;
+
+    if (address >= SIM_CSI1 && address < SIM_CSI1 + 0x800)
+        csi_write(address - SIM_CSI1, value);
+    else if (address == SIM_CM_CAM1CTL || address == SIM_CM_CAM1DIV || address == SIM_CSI1_CLKGATE)
+        clock_write(address, value);
+    else if (address >= SIM_BSC0 && address < SIM_BSC0 + sizeof(tI2cRegs))
+        bsc_write(address - SIM_BSC0, value);
+    else
+    {
+        sim_counts.sc_OtherWrites++;
+        *addr = value;
+    }
+}
+
+ULONG host_mmio_read(volatile ULONG *addr)
+{
+    ULONG address = (ULONG)(uintptr_t)addr;
+
+    /* Time passes while the resource polls */
+    if (address == SYSTIMER_CLO)
+        return now++;
+
+    if (address >= SIM_CSI1 && address < SIM_CSI1 + 0x800)
+        return csi_read(address - SIM_CSI1);
+    else if (address == SIM_CM_CAM1CTL || address == SIM_CM_CAM1DIV || address == SIM_CSI1_CLKGATE)
+        return clock_read(address);
+    else if (address >= SIM_BSC0 && address < SIM_BSC0 + sizeof(tI2cRegs))
+        return bsc_read(address - SIM_BSC0);
+
+    sim_counts.sc_OtherReads++;
+
+    return *addr;
+}
+
+/* Receiver takes frames: peripheral enabled, output engine running, clock and lane clocks on */
+static BOOL receiving(void)
+{
+    if (!sim_source.ss_Enabled || !(csi[UNICAM_CTRL / 4] & UNICAM_CPE) || (csi[UNICAM_CTRL / 4] & UNICAM_SOE))
+        return FALSE;
+
+    return (cam1ctl & CM_ENAB) && (clkgate & 1) != 0;
+}
+
+/* Start of a frame latches the image pointers for it */
+void sim_frame_start(void)
+{
+    if (in_frame || !receiving())
+        return;
+
+    ib_start = csi[UNICAM_IBSA0 / 4];
+    ib_end = csi[UNICAM_IBEA0 / 4];
+    if (ib_start == 0)
+        return;
+
+    in_frame = TRUE;
+    csi[UNICAM_IBWP / 4] = ib_start;
+    csi[UNICAM_ISTA / 4] |= UNICAM_FSI;
+}
+
+/*
+    End of the frame in progress. Only the window set in IHWIN/IVWIN is written, lines IBLS bytes
+    apart, and nothing beyond the end pointer latched at its start.
+*/
+void sim_frame_end(void)
+{
+    if (!in_frame)
+        return;
+
+    in_frame = FALSE;
+    if (!receiving())
+        return;
+
+    ULONG line = sim_source.ss_Width * (sim_source.ss_BPP / 8);
+    ULONG hwin = csi[UNICAM_IHWIN / 4];
+    ULONG vwin = csi[UNICAM_IVWIN / 4];
+    ULONG x0 = 0, x1 = line - 1;
+    ULONG y0 = 0, y1 = sim_source.ss_Height - 1;
+    ULONG stride = csi[UNICAM_IBLS / 4];
+    UBYTE *dst = bus_to_host(ib_start);
+    UBYTE *end = bus_to_host(ib_end);
+
+    if (hwin != 0)
+    {
+        x0 = hwin & 0xffff;
+        x1 = hwin >> 16;
+    }
+    if (vwin != 0)
+    {
+        y0 = vwin & 0xffff;
+        y1 = vwin >> 16;
+    }
+
+    for (ULONG y = y0; y <= y1 && y < sim_source.ss_Height; y++, dst += stride)
+    {
+        for (ULONG x = x0; x <= x1 && x < line; x++)
+        {
+            if (dst + (x - x0) >= end)
+            {
+                csi[UNICAM_STA / 4] |= UNICAM_BFO;
+                break;
+            }
+
+            dst[x - x0] = sim_source.ss_Pattern(frames, x, y);
+        }
+    }
+
+    csi[UNICAM_IBWP / 4] = ib_start + (ULONG)(dst - bus_to_host(ib_start));
+    csi[UNICAM_ISTA / 4] |= UNICAM_FEI;
+
+    frames++;
+}
+
+/* Address of the buffer the frame in progress is written to, 0 if none is */
+ULONG sim_write_address(void)
+{
+    return in_frame ? ib_start & ~0xC0000000 : 0;
+}
+
+ULONG sim_frames(void)
+{
+    return frames;
+}
+
+/*
+    One frame period passes: the frame in progress ends and the next one starts. The vertical blank
+    interrupt follows, so that it usually finds a frame in progress.
+*/
+void sim_tick(void)
+{
+    sim_frame_end();
+    sim_frame_start();
+    now += SIM_FRAME_PERIOD;
+    host_run_vblank();
+}
+
+void sim_reset_counts(void)
+{
+    memset(&sim_counts, 0, sizeof(sim_counts));
+}
+
+/* Mailbox: power domain requests succeed, clocks and display have fixed values */
+void MB_RawCommand(ULONG *command)
+{
+    switch (command[2])
+    {
+        case 0x00030002:
+            command[6] = 250000000;
+            break;
+        case 0x00040003:
+            command[5] = 1920;
+            command[6] = 1080;
+            break;
+    }
+}
+
+void sim_init(struct UnicamBase *UnicamBase)
+{
+    void *window = mmap((void *)SIM_PERIPH_BASE, SIM_PERIPH_SIZE, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if (window != (void *)SIM_PERIPH_BASE)
+    {
+        fprintf(stderr, "Cannot map peripheral window at %08x\n", SIM_PERIPH_BASE);
+        exit(2);
+    }
+
+    UnicamBase->u_PeriphBase = window;
+    unicam_init_interrupt(UnicamBase);
+
+    sim_source.ss_Pattern = sim_pattern;
+    host_idle_hook = sim_tick;
+}
@@ -0,0 +1,92 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef _SIM_H
+#define _SIM_H
+
+#include <exec/types.h>
+
+#include "unicam.h"
+
+/*
+    Peripherals as seen by the resource, mapped at the address Emu68 gives them. Registers which are
+    modelled are kept by the simulator, everything else in the window is plain memory. The HVS
+    display list lives there as well and is written by the resource directly.
+*/
+#define SIM_PERIPH_BASE     0xF2000000
+#define SIM_PERIPH_SIZE     0x01000000
+
+#define SIM_CSI1            (SIM_PERIPH_BASE + 0x801000)
+#define SIM_CSI1_CLKGATE    (SIM_PERIPH_BASE + 0x802004)
+#define SIM_CM_CAM1CTL      (SIM_PERIPH_BASE + 0x101048)
+#define SIM_CM_CAM1DIV      (SIM_PERIPH_BASE + 0x10104c)
+#define SIM_BSC0            (SIM_PERIPH_BASE + 0x205000)
+#define SIM_DLIST_VC4       (SIM_PERIPH_BASE + 0x402000)
+#define SIM_DLIST_VC6       (SIM_PERIPH_BASE + 0x404000)
+
+/*
+    One frame of the source every SIM_FRAME_PERIOD us. sim_tick() ends a frame, starts the next one
+    and runs the vertical blank servers. sim_frame_start() and sim_frame_end() raise the frame events
+    on their own, for polls which see only one of them.
+*/
+#define SIM_FRAME_PERIOD    20000
+
+/* Accesses made by the resource, per block */
+struct SimCounts {
+    ULONG   sc_CSIReads;
+    ULONG   sc_CSIWrites;
+    ULONG   sc_ClockReads;      // Clock manager and CSI clock gate
+    ULONG   sc_ClockWrites;
+    ULONG   sc_OtherReads;      // Plain memory of the window, system timer excluded
+    ULONG   sc_OtherWrites;
+};
+
+/* Fake CSI-2 source. Byte x of line y in frame n has the value returned by ss_Pattern */
+struct SimSource {
+    BOOL    ss_Enabled;
+    ULONG   ss_Width;
+    ULONG   ss_Height;
+    UBYTE   ss_BPP;
+    UBYTE   (*ss_Pattern)(ULONG frame, ULONG x, ULONG y);
+};
+
+/*
+    TC358743 on the I2C bus of BSC0. The first two bytes of a write set the register pointer, which
+    auto-increments over following data and over reads. A transfer is active for SIM_I2C_POLLS status
+    polls once all its bytes are in, a read started meanwhile continues with a repeated start.
+*/
+#define SIM_I2C_ADDR        0x0f
+#define SIM_I2C_POLLS       2
+
+struct SimI2C {
+    BOOL    si_Present;         // Chip acknowledges its address
+    BOOL    si_Stall;           // Clock held low, no transfer ever finishes
+    BOOL    si_Trace;           // Finished transfers are written with host_text()
+    ULONG   si_Writes;          // Finished write and read transfers
+    ULONG   si_Reads;
+    ULONG   si_RepeatedStarts;  // Reads which followed a write without stop
+    ULONG   si_Div;             // Clock divider as programmed
+    UBYTE   si_Regs[0x10000];
+};
+
+extern struct SimCounts sim_counts;
+extern struct SimSource sim_source;
+extern struct SimI2C sim_i2c;
+
+void sim_init(struct UnicamBase *UnicamBase);
+void sim_tick(void);
+void sim_frame_start(void);
+void sim_frame_end(void);
+ULONG sim_write_address(void);
+void sim_reset_counts(void);
+ULONG sim_csi_reg(ULONG offset);
+ULONG sim_frames(void);
+UBYTE sim_pattern(ULONG frame, ULONG x, ULONG y);
+
+#endif /* _SIM_H */
@@ -0,0 +1,212 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include <exec/types.h>
+
+#include "unicam.h"
+#include "i2c.h"
+#include "host.h"
+#include "sim.h"
+
+/*
+    Register image left in the TC358743 by init_c790_ic() for the default 576p50 profile on one lane,
+    compared with the one of the register by register sequence the tables replaced. Transfers go to
+    the golden file, so a change of the sequence shows in review.
+*/
+struct Reg {
+    UWORD   reg;
+    UWORD   size;
+    ULONG   value;
+};
+
+#define REG8(r, v)      { r, 1, v }
+#define REG16(r, v)     { r, 2, v }
+#define REG32(r, v)     { r, 4, v }
+#define EDID            { 0x8C00, 0, 0 }
+
+#define LINEINITCNT     0x0210
+#define TWAKEUP         0x0224
+
+/* One transfer each, delays left out */
+static const struct Reg baseline[] = {
+    REG16(0x0004, 0x0000),
+    REG16(0x0002, 0x0F00),
+    REG16(0x0002, 0x0000),
+    REG16(0x0006, 0x0080),
+    REG16(0x0008, 0x005F),
+    REG16(0x0014, 0xFFFF),
+    REG16(0x0016, 0x051F),
+    REG16(0x0020, 0x8111),
+    REG16(0x0022, 0x0213),
+    REG16(0x0004, 0x0E24),
+    REG32(0x0140, 0x00000000),
+    REG32(0x0144, 0x00000000),
+    REG32(0x0148, 0x00000001),
+    REG32(0x014C, 0x00000001),
+    REG32(0x0150, 0x00000001),
+    REG32(0x0210, 0x00002988),
+    REG32(0x0214, 0x00000005),
+    REG32(0x0218, 0x00001D04),
+    REG32(0x021C, 0x00000002),
+    REG32(0x0220, 0x00000504),
+    REG32(0x0224, 0x00004600),
+    REG32(0x0228, 0x0000000A),
+    REG32(0x022C, 0x00000004),
+    REG32(0x0234, 0x0000001F),
+    REG32(0x0204, 0x00000001),
+    REG32(0x0518, 0x00000001),
+    REG32(0x0500, 0xA3008080),
+    REG8(0x8502, 0x01),
+    REG8(0x8512, 0xFE),
+    REG8(0x8513, 0xDF),
+    REG8(0x8515, 0xFD),
+    REG8(0x8531, 0x01),
+    REG16(0x8540, 0x0A8C),
+    REG32(0x8630, 0x00041EB0),
+    REG8(0x8670, 0x01),
+    REG8(0x8532, 0x80),
+    REG8(0x8536, 0x40),
+    REG8(0x853F, 0x0A),
+    REG8(0x8543, 0x32),
+    REG8(0x8544, 0x10),
+    REG8(0x8545, 0x31),
+    REG8(0x8546, 0x2D),
+    REG8(0x85C7, 0x01),
+    REG8(0x85CB, 0x01),
+    EDID,
+    REG8(0x8544, 0x01),
+    REG8(0x8544, 0x00),
+    REG8(0x8544, 0x10),
+    REG8(0x85D1, 0x01),
+    REG8(0x8560, 0x24),
+    REG8(0x8563, 0x11),
+    REG8(0x8564, 0x0F),
+    REG8(0x8574, 0x00),
+    REG8(0x8573, 0x00),
+    REG8(0x8576, 0x00),
+    REG8(0x8600, 0x00),
+    REG8(0x8602, 0xF3),
+    REG8(0x8603, 0x02),
+    REG8(0x8604, 0x0C),
+    REG8(0x8606, 0x05),
+    REG8(0x8607, 0x00),
+    REG8(0x8620, 0x00),
+    REG8(0x8640, 0x01),
+    REG8(0x8641, 0x65),
+    REG8(0x8642, 0x07),
+    REG8(0x8652, 0x02),
+    REG8(0x8665, 0x10),
+    REG8(0x8709, 0xFF),
+    REG8(0x870B, 0x2C),
+    REG8(0x870C, 0x53),
+    REG8(0x870D, 0x01),
+    REG8(0x870E, 0x30),
+    REG8(0x9007, 0x10),
+    REG8(0x854A, 0x01),
+    REG16(0x0004, 0x0E27),
+};
+
+static const UBYTE baseline_edid[256] = {
+    0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x05, 0xd7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0x22, 0x01, 0x03, 0x80, 0x32, 0x1f, 0x78, 0x07, 0xee, 0x95, 0xa3, 0x54, 0x4c, 0x99, 0x26,
+    0x0f, 0x50, 0x54, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x8c, 0x0a, 0xd0, 0x90, 0x20, 0x40, 0x31, 0x20, 0x0c, 0x40,
+    0x55, 0x00, 0xd8, 0xac, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfd, 0x00, 0x17, 0xf0, 0x0f,
+    0xff, 0x0b, 0x00, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00, 0xfc, 0x00, 0x45,
+    0x44, 0x54, 0x56, 0x20, 0x35, 0x37, 0x36, 0x70, 0x0a, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xee,
+    0x02, 0x03, 0x16, 0x00, 0x41, 0xa5, 0x67, 0x03, 0x0c, 0x00, 0x00, 0x00, 0x11, 0x16, 0x67, 0xd8,
+    0x5d, 0xc4, 0x01, 0x16, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6b,
+};
+
+static UBYTE image[0x10000];
+static UBYTE written[0x10000];
+
+static void replay_baseline(void)
+{
+    for (unsigned i = 0; i < sizeof(baseline) / sizeof(baseline[0]); i++)
+    {
+        const struct Reg *r = &baseline[i];
+
+        if (r->size == 0)
+        {
+            memcpy(&image[r->reg], baseline_edid, 256);
+            memset(&written[r->reg], 1, 256);
+            continue;
+        }
+
+        for (int b = 0; b < r->size; b++)
+        {
+            image[r->reg + b] = r->value >> (8 * b);
+            written[r->reg + b] = 1;
+        }
+    }
+}
+
+static ULONG reg32(const UBYTE *regs, UWORD reg)
+{
+    return regs[reg] | (regs[reg + 1] << 8) | (regs[reg + 2] << 16) | ((ULONG)regs[reg + 3] << 24);
+}
+
+int main(void)
+{
+    struct UnicamBase *UnicamBase = host_unicam_base();
+
+    sim_init(UnicamBase);
+
+    UnicamBase->u_Lanes = 1;
+    UnicamBase->u_Mode = CSI_DT_RGB888;
+    UnicamBase->u_BPP = 24;
+
+    sim_i2c.si_Present = TRUE;
+    sim_i2c.si_Trace = TRUE;
+    init_c790_ic(UnicamBase);
+    sim_i2c.si_Trace = FALSE;
+
+    host_text("%u writes, %u reads, divider %u\n", sim_i2c.si_Writes, sim_i2c.si_Reads, sim_i2c.si_Div);
+
+    /* 400kHz from the 250MHz core clock given by the mailbox */
+    CHECK(sim_i2c.si_Div == 626);
+
+    /*
+        Only the chip ID is read. The old sequence took one transfer per register and 16 for the EDID,
+        90 in total. Runs of registers and the EDID halves go out as bursts now.
+    */
+    CHECK(sim_i2c.si_Reads == 1 && sim_i2c.si_RepeatedStarts == 1);
+    CHECK(sim_i2c.si_Writes == 49);
+    CHECK(sizeof(baseline) / sizeof(baseline[0]) - 1 + 256 / 16 == 90);
+
+    replay_baseline();
+
+    for (ULONG reg = 0; reg < 0x10000; reg++)
+    {
+        /* Line init and wakeup follow the D-PHY minimum at the link rate now, never shorter than before */
+        if ((reg & ~3) == LINEINITCNT || (reg & ~3) == TWAKEUP)
+            continue;
+
+        if (!CHECK(written[reg] && sim_i2c.si_Regs[reg] == image[reg] || !written[reg] && sim_i2c.si_Regs[reg] == 0))
+            fprintf(stderr, "register %04x: %02x, was %02x\n", reg, sim_i2c.si_Regs[reg], image[reg]);
+    }
+
+    CHECK(reg32(sim_i2c.si_Regs, LINEINITCNT) >= reg32(image, LINEINITCNT));
+    CHECK(reg32(sim_i2c.si_Regs, TWAKEUP) >= reg32(image, TWAKEUP));
+
+    host_golden_text("c790_init.txt");
+
+    return host_failures();
+}
@@ -0,0 +1,85 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+
+#include "unicam.h"
+#include "host.h"
+
+/*
+    Link timing computed for the modes of the EDID profiles. The 576p50 single lane RGB888 setup has
+    to give the values the bridge was hand-tuned with before, everything else goes to the golden file.
+*/
+struct Mode {
+    const char *name;
+    UWORD pixclk;       // 10kHz
+    UWORD hactive;
+    UWORD htotal;
+};
+
+static const struct Mode modes[] = {
+    { "288p50", 1350,  720,  864 },
+    { "480p60", 2700,  720,  858 },
+    { "576p50", 2700,  720,  864 },
+    { "576p60", 3240,  720,  864 },
+    { "720p50", 7425, 1280, 1980 },
+    { "720p60", 7425, 1280, 1650 },
+};
+
+int main(void)
+{
+    struct CSITiming t;
+
+    /* Known-good 576p50 on one lane, 822 Mbps */
+    CHECK(csi_compute_timing(&t, 2700, 720, 864, 24, 1));
+    CHECK(t.ct_Rate == 822000);
+    CHECK(t.ct_PLLCtl0 == 0x8111 && t.ct_PLLCtl1 == 0x0213);
+    CHECK(t.ct_LPTxTime == 5);
+    CHECK(t.ct_TClkHeader == 0x1d04);
+    CHECK(t.ct_TClkTrail == 2);
+    CHECK(t.ct_THSHeader == 0x0504);
+    CHECK(t.ct_TClkPost == 0x0a);
+    CHECK(t.ct_THSTrail == 4);
+    CHECK(csi_ths_settle(t.ct_Rate) == 6);
+
+    /* Line init and wakeup are no shorter than the hand-tuned 0x2988 and 0x4600 */
+    CHECK(t.ct_LineInit >= 0x2988 && t.ct_TWakeup >= 0x4600);
+
+    /* Unknown rate keeps the old settle count */
+    CHECK(csi_ths_settle(0) == 6);
+
+    for (unsigned m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+        for (UBYTE bpp = 16; bpp <= 24; bpp += 8)
+        {
+            for (UBYTE lanes = 1; lanes <= 2; lanes++)
+            {
+                const struct Mode *mode = &modes[m];
+                BOOL fits = csi_compute_timing(&t, mode->pixclk, mode->hactive, mode->htotal, bpp, lanes);
+                ULONG data = (ULONG)mode->pixclk * 10 * bpp / lanes * mode->hactive / mode->htotal;
+
+                host_text("%s %2u bpp %u lanes: %s rate %6u pll %04x %04x line %5u lptx %u tclk %04x %u"
+                    " ths %04x wakeup %5u post %2u trail %u settle %u\n",
+                    mode->name, bpp, lanes, fits ? "fits" : "FULL", t.ct_Rate, t.ct_PLLCtl0, t.ct_PLLCtl1,
+                    t.ct_LineInit, t.ct_LPTxTime, t.ct_TClkHeader, t.ct_TClkTrail, t.ct_THSHeader, t.ct_TWakeup,
+                    t.ct_TClkPost, t.ct_THSTrail, csi_ths_settle(t.ct_Rate));
+
+                /* Rate carries the active data within the limits of the bridge, with headroom below the top */
+                CHECK(t.ct_Rate <= 1000000 && t.ct_Rate >= 62500);
+                CHECK(fits == (t.ct_Rate >= data));
+                CHECK(t.ct_Rate >= data + data / 2 || t.ct_Rate + 3000 > 1000000);
+                CHECK(t.ct_Rate % 3000 == 0);
+            }
+        }
+    }
+
+    host_golden_text("csitiming.txt");
+
+    return host_failures();
+}
@@ -0,0 +1,156 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <string.h>
+
+#include <exec/types.h>
+
+#include "unicam.h"
+#include "videocore.h"
+#include "host.h"
+
+/*
+    Display lists built by UnicamConstructDL() for every HVS generation, pixel format, scaling mode
+    and filter pair. The receive buffer is never touched, it only has to give a fixed address.
+*/
+#define RECEIVE_BUFFER  0x1e000000
+#define DL_OFFSET       0x40
+
+struct Format {
+    const char *name;
+    UBYTE mode;
+    UBYTE bpp;
+    UBYTE order;
+};
+
+static const struct Format formats[] = {
+    { "rgb565", 0,                16, 0 },
+    { "rgb888", CSI_DT_RGB888,    24, 0 },
+    { "bgr888", CSI_DT_RGB888,    24, 1 },
+    { "yuv422", CSI_DT_YUV422_8,  16, 0 },
+};
+
+struct Scaling {
+    const char *name;
+    UWORD width, height;
+    UWORD x, y;
+    UWORD aspect;
+    UBYTE integer;
+};
+
+static const struct Scaling scalings[] = {
+    { "unity",   1920, 1080,  0,  0, 1000, 0 },
+    { "scaled",   720,  576,  0,  0, 1000, 0 },
+    { "cropped",  704,  540, 10, 18, 1000, 0 },
+    { "integer",  720,  288,  0,  0, 1000, 1 },
+    { "aspect",   720,  576,  0,  0, 1422, 0 },
+};
+
+static const UBYTE filters[][2] = {
+    { UNICAM_FILTER_DEFAULT, UNICAM_FILTER_DEFAULT },
+    { UNICAM_FILTER_MITCHELL, UNICAM_FILTER_MITCHELL },
+    { UNICAM_FILTER_LANCZOS3, UNICAM_FILTER_BSPLINE },
+};
+
+static void setup(struct UnicamBase *UnicamBase, const struct Format *f, const struct Scaling *s, BOOL vc6)
+{
+    UnicamBase->u_IsVC6 = vc6;
+    UnicamBase->u_Mode = f->mode;
+    UnicamBase->u_BPP = f->bpp;
+    UnicamBase->u_PixelOrder = f->order;
+    UnicamBase->u_FullSize.width = 720;
+    UnicamBase->u_FullSize.height = 576;
+    UnicamBase->u_Size.width = s->width;
+    UnicamBase->u_Size.height = s->height;
+    UnicamBase->u_Offset.x = s->x;
+    UnicamBase->u_Offset.y = s->y;
+    UnicamBase->u_Aspect = s->aspect;
+    UnicamBase->u_Integer = s->integer;
+    UnicamBase->u_ReceiveBuffer = (APTR)RECEIVE_BUFFER;
+
+    /* Unity case shows the full HD frame as captured */
+    if (s->width == 1920)
+    {
+        UnicamBase->u_FullSize.width = 1920;
+        UnicamBase->u_FullSize.height = 1080;
+    }
+
+    UnicamBase->u_Generation++;
+}
+
+static void dump(const ULONG *dlist, ULONG count)
+{
+    for (ULONG i = 0; i < count; i++)
+        host_text("%s%08x", (i % 8) == 0 ? "\n   " : " ", LE32(dlist[DL_OFFSET + i]));
+
+    host_text("\n");
+}
+
+int main(void)
+{
+    struct UnicamBase *UnicamBase = host_unicam_base();
+    ULONG dlist[DL_OFFSET + DL_MAX_WORDS + 8];
+
+    for (int vc6 = 0; vc6 < 2; vc6++)
+    {
+        for (unsigned f = 0; f < sizeof(formats) / sizeof(formats[0]); f++)
+        {
+            for (unsigned s = 0; s < sizeof(scalings) / sizeof(scalings[0]); s++)
+            {
+                for (unsigned k = 0; k < sizeof(filters) / sizeof(filters[0]); k++)
+                {
+                    setup(UnicamBase, &formats[f], &scalings[s], vc6);
+                    UnicamBase->u_Smooth = k == 0;
+                    UnicamBase->u_FilterH = filters[k][0];
+                    UnicamBase->u_FilterV = filters[k][1];
+
+                    memset(dlist, 0, sizeof(dlist));
+
+                    ULONG size = L_UnicamConstructDL(NULL, 0, UnicamBase);
+                    ULONG plane = L_UnicamConstructDL(dlist, DL_OFFSET, UnicamBase);
+                    ULONG words = UnicamBase->u_DLCacheWords;
+
+                    host_text("%s %s %s filter %d/%d: size %u plane %u words %u",
+                        vc6 ? "vc6" : "vc4", formats[f].name, scalings[s].name,
+                        filters[k][0], filters[k][1], size, plane, words);
+                    dump(dlist, words);
+
+                    CHECK(words <= size);
+                    CHECK(words <= DL_MAX_WORDS);
+                    CHECK(dlist[DL_OFFSET + words] == 0);
+                    CHECK(UnicamBase->u_DLLastAddress == &dlist[DL_OFFSET + UnicamBase->u_DLCacheAddress]);
+                    CHECK(LE32(*UnicamBase->u_DLLastAddress) == (0xc0000000 | unicam_display_address(UnicamBase)));
+                    CHECK(UnicamBase->u_DLAddressWord == NULL);
+
+                    /* Cached fragment is copied again unchanged, with a moved buffer only the address differs */
+                    ULONG first[DL_MAX_WORDS];
+                    memcpy(first, &dlist[DL_OFFSET], words * 4);
+
+                    CHECK(L_UnicamConstructDL(dlist, DL_OFFSET, UnicamBase) == plane);
+                    CHECK(memcmp(first, &dlist[DL_OFFSET], words * 4) == 0);
+
+                    UnicamBase->u_ReceiveBuffer = (APTR)(RECEIVE_BUFFER + 0x100000);
+                    L_UnicamConstructDL(dlist, DL_OFFSET, UnicamBase);
+
+                    for (ULONG i = 0; i < words; i++)
+                    {
+                        if (i == UnicamBase->u_DLCacheAddress)
+                            CHECK(LE32(dlist[DL_OFFSET + i]) == LE32(first[i]) + 0x100000);
+                        else
+                            CHECK(dlist[DL_OFFSET + i] == first[i]);
+                    }
+                }
+            }
+        }
+    }
+
+    host_golden_text("displaylist.txt");
+
+    return host_failures();
+}
@@ -0,0 +1,98 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <string.h>
+
+#include <exec/types.h>
+
+#include "framestats.h"
+#include "host.h"
+
+/* Frame period statistics computed from the ring: empty, partly filled, wrapped, dropped frames */
+static struct FrameStats stats;
+static struct UnicamStats out;
+
+static void feed(ULONG *now, ULONG count, ULONG period)
+{
+    for (ULONG i = 0; i < count; i++)
+    {
+        *now += period;
+        framestats_end(&stats, *now);
+    }
+}
+
+int main(void)
+{
+    ULONG now = 0;
+
+    /* Nothing captured yet */
+    framestats_compute(&stats, &out);
+    CHECK(out.us_Sequence == 0 && out.us_Frames == 0);
+    CHECK(out.us_PeriodMin == 0 && out.us_PeriodAvg == 0 && out.us_PeriodMax == 0 && out.us_Dropped == 0);
+
+    /* One frame gives no period */
+    feed(&now, 1, 20000);
+    framestats_compute(&stats, &out);
+    CHECK(out.us_Frames == 1 && out.us_PeriodMin == 0 && out.us_PeriodMax == 0);
+
+    /* Periods quantised to vertical blanks of 16667 and 16666us average to the true rate */
+    for (ULONG i = 0; i < 9; i++)
+        feed(&now, 1, i % 3 == 2 ? 16666 : 16667);
+
+    framestats_compute(&stats, &out);
+    CHECK(out.us_Sequence == 10 && out.us_Frames == 10);
+    CHECK(out.us_PeriodMin == 16666 && out.us_PeriodMax == 16667 && out.us_PeriodAvg == 16666);
+    CHECK(out.us_Dropped == 0);
+
+    /* Ring wraps, only the newest FRAME_STATS_SIZE frames count and the timer may overflow */
+    memset(&stats, 0, sizeof(stats));
+    now = 0xffffffff - 5 * 20000;
+    feed(&now, FRAME_STATS_SIZE + 10, 20000);
+
+    framestats_compute(&stats, &out);
+    CHECK(out.us_Sequence == FRAME_STATS_SIZE + 10 && out.us_Frames == FRAME_STATS_SIZE);
+    CHECK(out.us_PeriodMin == 20000 && out.us_PeriodAvg == 20000 && out.us_PeriodMax == 20000);
+
+    /* A gap of three periods counts two dropped frames and stays out of the maximum */
+    feed(&now, 1, 60000);
+    feed(&now, 1, 21000);
+    feed(&now, 1, 40000);
+
+    framestats_compute(&stats, &out);
+    CHECK(out.us_PeriodMin == 20000 && out.us_PeriodMax == 21000);
+    CHECK(out.us_Dropped == 3);
+
+    /* Slow drift stays within 1.5 periods, nothing is dropped */
+    memset(&stats, 0, sizeof(stats));
+    now = 0;
+    for (ULONG i = 0; i < FRAME_STATS_SIZE; i++)
+        feed(&now, 1, 20000 + i * 100);
+
+    framestats_compute(&stats, &out);
+    CHECK(out.us_Frames == FRAME_STATS_SIZE && out.us_Dropped == 0);
+    CHECK(out.us_PeriodMin == 20100 && out.us_PeriodMax == 20000 + (FRAME_STATS_SIZE - 1) * 100);
+
+    /* Capture restarted, the pause is no dropped frame and the sequence goes on */
+    memset(&stats, 0, sizeof(stats));
+    now = 0;
+    feed(&now, 10, 20000);
+    framestats_reset(&stats);
+
+    framestats_compute(&stats, &out);
+    CHECK(out.us_Sequence == 10 && out.us_Frames == 0 && out.us_Dropped == 0);
+
+    feed(&now, 1, 500000);
+    feed(&now, 4, 20000);
+
+    framestats_compute(&stats, &out);
+    CHECK(out.us_Sequence == 15 && out.us_Frames == 5);
+    CHECK(out.us_PeriodMin == 20000 && out.us_PeriodMax == 20000 && out.us_Dropped == 0);
+
+    return host_failures();
+}
@@ -0,0 +1,166 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <string.h>
+
+#include <exec/types.h>
+#include <exec/memory.h>
+
+#include <proto/exec.h>
+
+#include "unicam.h"
+#include "host.h"
+
+/*
+    UnicamGrabFrame() of every output format from RGB888 and RGB565 capture in both pixel orders,
+    checked pixel by pixel against a plain reference. Capture is stopped, the grab takes the single
+    buffer as it is.
+*/
+#define WIDTH   37
+#define HEIGHT  11
+#define ALIGN   64
+
+static const UBYTE grab_bpp[UNICAM_GRAB_COUNT] = { 3, 3, 4, 4, 2, 2 };
+
+static UBYTE *setup(struct UnicamBase *UnicamBase, UBYTE bpp, UBYTE order)
+{
+    static UBYTE *buffer;
+
+    if (buffer == NULL)
+        buffer = AllocMem(ALIGN * 2 * HEIGHT * 4, MEMF_CLEAR);
+
+    UnicamBase->u_Running = FALSE;
+    UnicamBase->u_Mode = bpp == 24 ? CSI_DT_RGB888 : 0;
+    UnicamBase->u_BPP = bpp;
+    UnicamBase->u_PixelOrder = order;
+    UnicamBase->u_FullSize.width = WIDTH;
+    UnicamBase->u_FullSize.height = HEIGHT;
+    UnicamBase->u_Size = UnicamBase->u_FullSize;
+    UnicamBase->u_StrideAlign = ALIGN;
+    UnicamBase->u_ActiveBuffers = 1;
+    UnicamBase->u_DisplayBuffer = 0;
+    UnicamBase->u_Buffers[0] = buffer;
+
+    ULONG stride = unicam_stride(UnicamBase);
+
+    for (ULONG i = 0; i < stride * HEIGHT; i++)
+        buffer[i] = i * 29 + (i >> 7) * 3 + 1;
+
+    return buffer;
+}
+
+/* Components of captured pixel x, y expanded to 8 bits */
+static void source_pixel(const UBYTE *buffer, ULONG stride, UBYTE bpp, UBYTE order, ULONG x, ULONG y, UBYTE rgb[3])
+{
+    const UBYTE *p = buffer + y * stride + x * (bpp / 8);
+
+    if (bpp == 24)
+    {
+        rgb[0] = order == 0 ? p[2] : p[0];
+        rgb[1] = p[1];
+        rgb[2] = order == 0 ? p[0] : p[2];
+    }
+    else
+    {
+        UWORD w = p[0] | (p[1] << 8);
+        UBYTE hi = w >> 11, g = (w >> 5) & 0x3f, lo = w & 0x1f;
+        UBYTE r = order == 0 ? hi : lo;
+        UBYTE b = order == 0 ? lo : hi;
+
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+}
+
+static BOOL pixel_matches(const UBYTE *d, ULONG format, const UBYTE rgb[3])
+{
+    UWORD rgb16 = ((rgb[0] & 0xf8) << 8) | ((rgb[1] & 0xfc) << 3) | (rgb[2] >> 3);
+
+    switch (format)
+    {
+        case UNICAM_GRAB_RGB24:     return d[0] == rgb[0] && d[1] == rgb[1] && d[2] == rgb[2];
+        case UNICAM_GRAB_BGR24:     return d[0] == rgb[2] && d[1] == rgb[1] && d[2] == rgb[0];
+        case UNICAM_GRAB_ARGB32:    return d[0] == 0xff && d[1] == rgb[0] && d[2] == rgb[1] && d[3] == rgb[2];
+        case UNICAM_GRAB_BGRA32:    return d[0] == rgb[2] && d[1] == rgb[1] && d[2] == rgb[0] && d[3] == 0xff;
+        case UNICAM_GRAB_RGB16:     return d[0] == (rgb16 >> 8) && d[1] == (rgb16 & 0xff);
+        case UNICAM_GRAB_RGB16PC:   return d[1] == (rgb16 >> 8) && d[0] == (rgb16 & 0xff);
+    }
+
+    return FALSE;
+}
+
+int main(void)
+{
+    struct UnicamBase *UnicamBase = host_unicam_base();
+    UBYTE *dest = AllocMem(WIDTH * HEIGHT * 4 + 16, MEMF_CLEAR);
+    struct UnicamRect rect = { 5, 3, 20, 7 };
+
+    for (UBYTE bpp = 16; bpp <= 24; bpp += 8)
+    {
+        for (UBYTE order = 0; order < 2; order++)
+        {
+            const UBYTE *buffer = setup(UnicamBase, bpp, order);
+            ULONG stride = unicam_stride(UnicamBase);
+
+            for (ULONG format = 0; format < UNICAM_GRAB_COUNT; format++)
+            {
+                ULONG size = WIDTH * HEIGHT * grab_bpp[format];
+                BOOL ok = TRUE;
+
+                /* Whole crop rectangle, nothing written past its end */
+                memset(dest, 0xa5, WIDTH * HEIGHT * 4 + 16);
+                CHECK(L_UnicamGrabFrame(dest, format, NULL, UnicamBase) == size);
+                CHECK(dest[size] == 0xa5);
+
+                for (ULONG y = 0; y < HEIGHT; y++)
+                {
+                    for (ULONG x = 0; x < WIDTH; x++)
+                    {
+                        UBYTE rgb[3];
+
+                        source_pixel(buffer, stride, bpp, order, x, y, rgb);
+                        ok &= pixel_matches(&dest[(y * WIDTH + x) * grab_bpp[format]], format, rgb);
+                    }
+                }
+
+                CHECK(ok);
+
+                /* Rectangle within the frame, lines packed */
+                CHECK(L_UnicamGrabFrame(dest, format, &rect, UnicamBase) == rect.ur_Width * rect.ur_Height * grab_bpp[format]);
+
+                for (ULONG y = 0; y < rect.ur_Height; y++)
+                {
+                    for (ULONG x = 0; x < rect.ur_Width; x++)
+                    {
+                        UBYTE rgb[3];
+
+                        source_pixel(buffer, stride, bpp, order, rect.ur_X + x, rect.ur_Y + y, rgb);
+                        ok &= pixel_matches(&dest[(y * rect.ur_Width + x) * grab_bpp[format]], format, rgb);
+                    }
+                }
+
+                CHECK(ok);
+            }
+        }
+    }
+
+    /* Rectangle leaving the frame, unknown format and YUV capture are refused */
+    struct UnicamRect outside = { 30, 0, 8, 1 };
+
+    setup(UnicamBase, 24, 0);
+    CHECK(L_UnicamGrabFrame(dest, UNICAM_GRAB_RGB24, &outside, UnicamBase) == 0);
+    CHECK(L_UnicamGrabFrame(dest, UNICAM_GRAB_COUNT, NULL, UnicamBase) == 0);
+
+    UnicamBase->u_Mode = CSI_DT_YUV422_8;
+    UnicamBase->u_BPP = 16;
+    CHECK(L_UnicamGrabFrame(dest, UNICAM_GRAB_RGB24, NULL, UnicamBase) == 0);
+
+    return host_failures();
+}
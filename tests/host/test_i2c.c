@@ -0,0 +1,109 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <string.h>
+
+#include <exec/types.h>
+
+#include "unicam.h"
+#include "i2c.h"
+#include "host.h"
+#include "sim.h"
+
+/*
+    TransferI2C() against the simulated BSC: combined register reads with repeated start, writes
+    longer than the FIFO, a chip which does not answer and a bus with the clock held low.
+*/
+#define CHIP    (SIM_I2C_ADDR << 1)
+
+#define SUCCESS(res)    ((res) & 0xff)
+#define IO_ERROR(res)   (((res) >> 8) & 0xff)
+
+static volatile tI2cRegs *const bsc = (volatile tI2cRegs *)SIM_BSC0;
+
+int main(void)
+{
+    struct UnicamBase *UnicamBase = host_unicam_base();
+    UBYTE pointer[2] = { 0x85, 0x82 };
+    UBYTE data[2 + 200];
+    UBYTE buf[200];
+    ULONG res;
+
+    sim_init(UnicamBase);
+    sim_i2c.si_Present = TRUE;
+
+    for (int i = 0; i < 200; i++)
+        sim_i2c.si_Regs[0x8582 + i] = i * 3 + 1;
+
+    /* Combined read: pointer write and read without stop between them, pointer auto-increments */
+    res = TransferI2C(CHIP, 2, pointer, 4, buf, bsc);
+    CHECK(SUCCESS(res) && IO_ERROR(res) == 0);
+    CHECK(sim_i2c.si_Writes == 1 && sim_i2c.si_Reads == 1 && sim_i2c.si_RepeatedStarts == 1);
+    CHECK(buf[0] == 1 && buf[1] == 4 && buf[2] == 7 && buf[3] == 10);
+    CHECK(!(host_mmio_read(&bsc->S) & (I2C_S_TA | I2C_S_DONE | I2C_S_ERR)));
+
+    /* Read continues where the last one ended */
+    res = ReceiveI2C(CHIP, 2, buf, bsc);
+    CHECK(SUCCESS(res) && buf[0] == 13 && buf[1] == 16);
+    CHECK(sim_i2c.si_RepeatedStarts == 1);
+
+    /* Read of more than the FIFO holds */
+    res = TransferI2C(CHIP, 2, pointer, 100, buf, bsc);
+    CHECK(SUCCESS(res));
+    for (int i = 0; i < 100; i++)
+        CHECK(buf[i] == (UBYTE)(i * 3 + 1));
+
+    /* Write longer than the FIFO is fed while the transfer runs, a read after it starts anew */
+    data[0] = 0x87;
+    data[1] = 0x00;
+    for (int i = 0; i < 200; i++)
+        data[2 + i] = 0xff - i;
+
+    sim_i2c.si_RepeatedStarts = 0;
+    res = TransferI2C(CHIP, sizeof(data), data, 1, buf, bsc);
+    CHECK(SUCCESS(res) && sim_i2c.si_RepeatedStarts == 0);
+    CHECK(memcmp(&sim_i2c.si_Regs[0x8700], &data[2], 200) == 0);
+
+    /* Chip not there: address is not acknowledged, status is left clean for the next transfer */
+    sim_i2c.si_Present = FALSE;
+
+    res = SendI2C(CHIP, 4, data, bsc);
+    CHECK(!SUCCESS(res) && IO_ERROR(res) == I2C_REJECT);
+    res = TransferI2C(CHIP, 2, pointer, 2, buf, bsc);
+    CHECK(!SUCCESS(res) && IO_ERROR(res) == I2C_NO_REPLY);
+    res = TransferI2C(CHIP, sizeof(data), data, 2, buf, bsc);
+    CHECK(!SUCCESS(res) && IO_ERROR(res) == I2C_NO_REPLY);
+    CHECK(!(host_mmio_read(&bsc->S) & (I2C_S_TA | I2C_S_DONE | I2C_S_ERR)));
+
+    /* Clock held low: every kind of transfer gives up after its deadline and leaves the bus idle */
+    static const UWORD sizes[][2] = { { 2, 4 }, { 20, 0 }, { 0, 8 }, { 40, 2 } };
+
+    sim_i2c.si_Present = TRUE;
+    sim_i2c.si_Stall = TRUE;
+
+    for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        ULONG start = systimer_read();
+
+        res = TransferI2C(CHIP, sizes[i][0], data, sizes[i][1], buf, bsc);
+        ULONG elapsed = systimer_read() - start;
+
+        CHECK(!SUCCESS(res) && IO_ERROR(res) == SCL_TIMEOUT);
+        CHECK(elapsed > I2C_TIMEOUT(sizes[i][0] + sizes[i][1]));
+        CHECK(elapsed < I2C_TIMEOUT(sizes[i][0] + sizes[i][1]) + 100);
+        CHECK(!(host_mmio_read(&bsc->S) & I2C_S_TA));
+    }
+
+    /* Bus works again once the clock is released */
+    sim_i2c.si_Stall = FALSE;
+    res = TransferI2C(CHIP, 2, pointer, 2, buf, bsc);
+    CHECK(SUCCESS(res) && buf[0] == 1 && buf[1] == 4);
+
+    return host_failures();
+}
@@ -0,0 +1,64 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+
+#include "unicam.h"
+#include "smoothing.h"
+#include "host.h"
+
+/* Scaling kernels of all fixed filters and of Mitchell-Netravali for a few B and C pairs */
+static const UWORD mitchell[][2] = {
+    { 0, 0 },
+    { 0, 500 },
+    { 250, 750 },
+    { 333, 333 },
+    { 1000, 0 },
+};
+
+static void dump(const char *name, ULONG b, ULONG c, const ULONG *kernel)
+{
+    host_text("%s %u/%u:", name, b, c);
+
+    for (int i = 0; i < DL_KERNEL_WORDS; i++)
+        host_text(" %08x", kernel[i]);
+
+    host_text("\n");
+}
+
+int main(void)
+{
+    ULONG kernel[DL_KERNEL_WORDS + 1];
+
+    for (UBYTE filter = UNICAM_FILTER_NEAREST; filter < UNICAM_FILTER_COUNT; filter++)
+    {
+        /* Computed from B and C at run time, see below */
+        if (filter == UNICAM_FILTER_MITCHELL)
+            continue;
+
+        kernel[DL_KERNEL_WORDS] = 0xdeadbeef;
+        compute_filter_kernel(kernel, filter);
+        dump("filter", filter, 0, kernel);
+
+        CHECK(kernel[DL_KERNEL_WORDS] == 0xdeadbeef);
+    }
+
+    for (unsigned i = 0; i < sizeof(mitchell) / sizeof(mitchell[0]); i++)
+    {
+        kernel[DL_KERNEL_WORDS] = 0xdeadbeef;
+        compute_scaling_kernel(kernel, (mitchell[i][0] * 256) / 1000, (mitchell[i][1] * 256) / 1000);
+        dump("mitchell", mitchell[i][0], mitchell[i][1], kernel);
+
+        CHECK(kernel[DL_KERNEL_WORDS] == 0xdeadbeef);
+    }
+
+    host_golden_text("kernels.txt");
+
+    return host_failures();
+}
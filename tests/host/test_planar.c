@@ -0,0 +1,164 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <string.h>
+
+#include <exec/types.h>
+#include <exec/memory.h>
+#include <graphics/gfx.h>
+
+#include <proto/exec.h>
+
+#include "unicam.h"
+#include "host.h"
+
+/*
+    UnicamGrabPlanar() into plain, padded and interleaved bitmaps at unity scale, read back pixel by
+    pixel and compared with the RGB332 or grey index of the captured pixel.
+*/
+#define WIDTH   64
+#define HEIGHT  16
+
+static UBYTE *frame;
+
+static void setup(struct UnicamBase *UnicamBase)
+{
+    frame = AllocMem(WIDTH * 3 * HEIGHT, MEMF_CLEAR);
+
+    UnicamBase->u_Running = FALSE;
+    UnicamBase->u_Mode = CSI_DT_RGB888;
+    UnicamBase->u_BPP = 24;
+    UnicamBase->u_PixelOrder = 0;
+    UnicamBase->u_FullSize.width = WIDTH;
+    UnicamBase->u_FullSize.height = HEIGHT;
+    UnicamBase->u_Size = UnicamBase->u_FullSize;
+    UnicamBase->u_StrideAlign = 0;
+    UnicamBase->u_ActiveBuffers = 1;
+    UnicamBase->u_DisplayBuffer = 0;
+    UnicamBase->u_Buffers[0] = frame;
+
+    /* B, G, R in memory */
+    for (ULONG y = 0; y < HEIGHT; y++)
+    {
+        for (ULONG x = 0; x < WIDTH; x++)
+        {
+            UBYTE *p = &frame[(y * WIDTH + x) * 3];
+
+            p[2] = x * 4;
+            p[1] = y * 16 + x;
+            p[0] = 255 - x * 3 - y;
+        }
+    }
+}
+
+static UBYTE expected(ULONG x, ULONG y, BOOL grey)
+{
+    const UBYTE *p = &frame[(y * WIDTH + x) * 3];
+
+    if (grey)
+        return ((77 * p[2] + 150 * p[1] + 29 * p[0]) >> 8) >> 4;
+
+    return (p[2] & 0xe0) | ((p[1] >> 5) << 2) | (p[0] >> 6);
+}
+
+static UBYTE read_pixel(const struct BitMap *bm, ULONG x, ULONG y)
+{
+    UBYTE index = 0;
+
+    for (int p = 0; p < bm->Depth; p++)
+        index |= ((bm->Planes[p][y * bm->BytesPerRow + (x >> 3)] >> (7 - (x & 7))) & 1) << p;
+
+    return index;
+}
+
+/* Plane rows of bytes bytes, modulo BytesPerRow apart, interleaved ones share a single block */
+static void alloc_bitmap(struct BitMap *bm, UBYTE depth, UWORD bytes, BOOL interleaved)
+{
+    memset(bm, 0, sizeof(*bm));
+    bm->Depth = depth;
+    bm->Rows = HEIGHT;
+    bm->Flags = interleaved ? BMF_INTERLEAVED : 0;
+    bm->BytesPerRow = interleaved ? bytes * depth : bytes;
+
+    UBYTE *block = AllocMem(bytes * depth * HEIGHT, MEMF_ANY);
+    memset(block, 0xa5, bytes * depth * HEIGHT);
+
+    for (int p = 0; p < depth; p++)
+        bm->Planes[p] = interleaved ? block + p * bytes : block + p * bytes * HEIGHT;
+}
+
+static BOOL compare(const struct BitMap *bm, ULONG width, BOOL grey)
+{
+    BOOL ok = TRUE;
+
+    for (ULONG y = 0; y < HEIGHT; y++)
+        for (ULONG x = 0; x < width; x++)
+            ok &= read_pixel(bm, x, y) == expected(x, y, grey);
+
+    return ok;
+}
+
+int main(void)
+{
+    struct UnicamBase *UnicamBase = host_unicam_base();
+    struct BitMap bm;
+
+    setup(UnicamBase);
+
+    /* Plain bitmap as wide as its rows */
+    alloc_bitmap(&bm, 8, WIDTH / 8, FALSE);
+    CHECK(L_UnicamGrabPlanar(&bm, NULL, NULL, 0, 0, UnicamBase) == WIDTH * HEIGHT);
+    CHECK(compare(&bm, WIDTH, FALSE));
+
+    /* Interleaved: one row of the block holds all planes, the width is a row of one plane */
+    alloc_bitmap(&bm, 8, WIDTH / 8, TRUE);
+    CHECK(L_UnicamGrabPlanar(&bm, NULL, NULL, 0, 0, UnicamBase) == WIDTH * HEIGHT);
+    CHECK(compare(&bm, WIDTH, FALSE));
+
+    /* Rows padded to twice the width: padding is left alone if the width is given */
+    alloc_bitmap(&bm, 8, WIDTH / 4, FALSE);
+    CHECK(L_UnicamGrabPlanar(&bm, NULL, NULL, 0, WIDTH, UnicamBase) == WIDTH * HEIGHT);
+    CHECK(compare(&bm, WIDTH, FALSE));
+
+    BOOL untouched = TRUE;
+    for (int p = 0; p < 8; p++)
+        for (ULONG y = 0; y < HEIGHT; y++)
+            for (ULONG b = WIDTH / 8; b < WIDTH / 4; b++)
+                untouched &= bm.Planes[p][y * bm.BytesPerRow + b] == 0xa5;
+    CHECK(untouched);
+
+    /* Width not a multiple of 8, the rest of the last byte repeats the last source pixel */
+    struct UnicamRect src = { 0, 0, 60, HEIGHT };
+
+    alloc_bitmap(&bm, 8, WIDTH / 8, FALSE);
+    CHECK(L_UnicamGrabPlanar(&bm, &src, NULL, 0, 60, UnicamBase) == WIDTH * HEIGHT);
+    CHECK(compare(&bm, 60, FALSE));
+    CHECK(read_pixel(&bm, 63, 5) == expected(59, 5, FALSE));
+
+    /* Grey on 4 interleaved planes, only the region is written */
+    struct UnicamRect region = { 17, 2, 20, 5 };
+
+    alloc_bitmap(&bm, 4, WIDTH / 8, TRUE);
+    CHECK(L_UnicamGrabPlanar(&bm, NULL, &region, UNICAM_PLANARF_GREY, 0, UnicamBase) == 24 * 5);
+
+    BOOL ok = TRUE;
+    for (ULONG y = 0; y < HEIGHT; y++)
+    {
+        for (ULONG x = 0; x < WIDTH; x++)
+        {
+            if (y >= 2 && y < 7 && x >= 16 && x < 40)
+                ok &= read_pixel(&bm, x, y) == expected(x, y, TRUE);
+            else
+                ok &= read_pixel(&bm, x, y) == (0xa5 >> (7 - (x & 7)) & 1 ? 0x0f : 0);
+        }
+    }
+    CHECK(ok);
+
+    return host_failures();
+}
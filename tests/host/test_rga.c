@@ -0,0 +1,82 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <exec/types.h>
+
+#include "rga_host.h"
+#include "host.h"
+
+/* Command frames sent to the RGA and decoding of its replies */
+static const struct {
+    uint8_t cmd;
+    uint32_t addr;
+    uint16_t payload;
+} commands[] = {
+    { FTCMD_READ,         0x00000010, 0 },
+    { FTCMD_WRITE,        0x00001ffe, 0xbeef },
+    { FTCMD_FLASH_ERASE,  0,          0 },
+    { FTCMD_FLASH_DATA,   0,          0x1234 },
+    { FTCMD_FLASH_COMMIT, 0x00012000, 0 },
+    { FTCMD_GET_VERSION,  0,          6 },
+    { FTCMD_GET_STATUS,   0,          0 },
+    { FTCMD_SET_SCANLINE, 0,          0x0302 },
+};
+
+static void reply(uint16_t *rx, uint16_t status, uint16_t payload)
+{
+    rx[0] = STX_MAGIC;
+    rx[1] = status;
+    rx[2] = 0;
+    rx[3] = payload;
+    rx[4] = rx[0] ^ rx[1] ^ rx[2] ^ rx[3];
+    rx[5] = ETX_MAGIC;
+}
+
+int main(void)
+{
+    uint16_t tx[RGA_MAX_FRAME + 1];
+    uint16_t rx[6];
+    uint16_t payload;
+
+    for (unsigned i = 0; i < sizeof(commands) / sizeof(commands[0]); i++)
+    {
+        tx[RGA_MAX_FRAME] = 0xdead;
+
+        int count = rga_encode_cmd(tx, commands[i].cmd, commands[i].addr, commands[i].payload);
+
+        host_text("cmd %02x:", commands[i].cmd);
+        for (int w = 0; w < count; w++)
+            host_text(" %04x", tx[w]);
+        host_text("\n");
+
+        CHECK(count <= RGA_MAX_FRAME);
+        CHECK(tx[RGA_MAX_FRAME] == 0xdead);
+        CHECK(tx[0] == STX_MAGIC && tx[count - 1] == ETX_MAGIC);
+    }
+
+    reply(rx, STATUS_OK, 0x4142);
+    payload = 0;
+    CHECK(rga_decode_reply(rx, &payload) && payload == 0x4142);
+    CHECK(rga_decode_reply(rx, NULL));
+
+    reply(rx, STATUS_ERR_ADDR, 0x4142);
+    CHECK(!rga_decode_reply(rx, &payload));
+
+    reply(rx, STATUS_OK, 0x4142);
+    rx[4] ^= 1;
+    CHECK(!rga_decode_reply(rx, &payload));
+
+    reply(rx, STATUS_OK, 0x4142);
+    rx[5] = 0;
+    CHECK(!rga_decode_reply(rx, &payload));
+
+    host_golden_text("rga.txt");
+
+    return host_failures();
+}
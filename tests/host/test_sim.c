@@ -0,0 +1,303 @@
+/*
+    Copyright © 2025 Michal Schulz <michal.schulz@gmx.de>
+    https://github.com/michalsc
+
+    This Source Code Form is subject to the terms of the
+    Mozilla Public License, v. 2.0. If a copy of the MPL was not distributed
+    with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <stdio.h>
+
+#include <exec/types.h>
+#include <exec/memory.h>
+
+#include <proto/exec.h>
+
+#include "unicam.h"
+#include "vc4-regs-unicam.h"
+#include "host.h"
+#include "sim.h"
+
+/*
+    Capture through the real unicam_run() and unicam_stop() against the simulated receiver: start,
+    frames rotating through three buffers, the display list following them, a moved capture window
+    and stop. MMIO accesses of each call go to the golden file, so that a change shows in review.
+*/
+#define WIDTH   720
+#define HEIGHT  576
+#define DL_OFFSET   0x40
+
+static void counts(const char *call, struct UnicamBase *UnicamBase, ULONG dl_words)
+{
+    host_text("%-20s CSI %2u reads %2u writes, clock %u reads %u writes, other %u reads %u writes, display list %2u words\n",
+        call, sim_counts.sc_CSIReads, sim_counts.sc_CSIWrites, sim_counts.sc_ClockReads, sim_counts.sc_ClockWrites,
+        sim_counts.sc_OtherReads, sim_counts.sc_OtherWrites, dl_words);
+
+    /*
+        Counters of the resource have to agree. They leave out polling of the clock manager, but
+        include words of the display list, which is plain memory to the simulator.
+    */
+    CHECK(UnicamBase->u_MmioReads == sim_counts.sc_CSIReads);
+    CHECK(UnicamBase->u_MmioWrites == sim_counts.sc_CSIWrites + sim_counts.sc_ClockWrites + dl_words);
+
+    UnicamBase->u_MmioReads = 0;
+    UnicamBase->u_MmioWrites = 0;
+    sim_reset_counts();
+}
+
+/* Captured frame in buffer holds the window of given frame of the source */
+static BOOL frame_matches(struct UnicamBase *UnicamBase, const UBYTE *buffer, ULONG frame)
+{
+    struct Point offset;
+    struct Size size;
+    ULONG stride = unicam_stride(UnicamBase);
+
+    unicam_get_window(UnicamBase, &offset, &size);
+
+    for (ULONG y = 0; y < size.height; y++)
+    {
+        for (ULONG x = 0; x < size.width * 3; x++)
+        {
+            if (buffer[y * stride + x] != sim_pattern(frame, offset.x * 3 + x, offset.y + y))
+                return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+int main(void)
+{
+    struct UnicamBase *UnicamBase = host_unicam_base();
+    volatile ULONG *dlist = (volatile ULONG *)SIM_DLIST_VC4;
+
+    sim_init(UnicamBase);
+
+    UnicamBase->u_Mode = CSI_DT_RGB888;
+    UnicamBase->u_BPP = 24;
+    UnicamBase->u_FullSize.width = WIDTH;
+    UnicamBase->u_FullSize.height = HEIGHT;
+    UnicamBase->u_Size = UnicamBase->u_FullSize;
+    UnicamBase->u_BufferCount = 3;
+    UnicamBase->u_StrideAlign = 64;
+
+    sim_source.ss_Enabled = TRUE;
+    sim_source.ss_Width = WIDTH;
+    sim_source.ss_Height = HEIGHT;
+    sim_source.ss_BPP = 24;
+
+    CHECK(unicam_alloc_receive(UnicamBase, WIDTH, HEIGHT, 24, 3));
+
+    sim_reset_counts();
+    L_UnicamStart(UnicamBase->u_ReceiveBuffer, 2, CSI_DT_RGB888, WIDTH, HEIGHT, 24, UnicamBase);
+    counts("UnicamStart", UnicamBase, 0);
+
+    CHECK(UnicamBase->u_Running && host_int_servers() == 1);
+    CHECK(UnicamBase->u_ActiveBuffers == 3);
+    CHECK((sim_csi_reg(UNICAM_CTRL) & (UNICAM_CPE | UNICAM_SOE | UNICAM_CPR)) == UNICAM_CPE);
+    CHECK(sim_csi_reg(UNICAM_DAT0) != 0 && sim_csi_reg(UNICAM_DAT1) != 0 && sim_csi_reg(UNICAM_DAT2) == 0);
+    CHECK(sim_csi_reg(UNICAM_IBLS) == 2176);
+    CHECK((host_mmio_read((volatile ULONG *)SIM_CSI1_CLKGATE) & 0xff) == 0x15);
+    sim_reset_counts();
+
+    L_UnicamConstructDL((ULONG *)dlist, DL_OFFSET, UnicamBase);
+    counts("UnicamConstructDL", UnicamBase, UnicamBase->u_DLCacheWords);
+
+    /* Only the plane written last can be registered */
+    CHECK(!L_UnicamRegisterDL((ULONG *)dlist, DL_OFFSET + 1, UnicamBase));
+    CHECK(UnicamBase->u_DLAddressWord == NULL);
+    CHECK(L_UnicamRegisterDL((ULONG *)dlist, DL_OFFSET, UnicamBase));
+    counts("UnicamRegisterDL", UnicamBase, 1);
+
+    /* Frames go to buffers 0, 1, 2, 0... and the display list shows the last complete one */
+    for (ULONG i = 0; i < 5; i++)
+    {
+        ULONG sequence = L_UnicamWaitFrame(UnicamBase);
+        UBYTE shown = UnicamBase->u_DisplayBuffer;
+
+        CHECK(sequence == i + 1);
+        CHECK(shown == i % 3);
+        CHECK(LE32(*UnicamBase->u_DLAddressWord) == (0xc0000000 | (ULONG)UnicamBase->u_Buffers[shown]));
+        CHECK(frame_matches(UnicamBase, UnicamBase->u_Buffers[shown], i));
+    }
+    counts("5 frames", UnicamBase, 5);
+
+    /* Fewer and more buffers while capturing, the display list keeps showing a complete frame */
+    static const UBYTE counts_sequence[] = { 2, 1, 3 };
+
+    for (int n = 0; n < 3; n++)
+    {
+        UBYTE count = counts_sequence[n];
+
+        L_UnicamSetBuffers(count, UnicamBase);
+        char name[32];
+        snprintf(name, sizeof(name), "UnicamSetBuffers(%d)", count);
+        counts(name, UnicamBase, 1);
+
+        CHECK(UnicamBase->u_ActiveBuffers == count);
+        CHECK(UnicamBase->u_DisplayBuffer < count && UnicamBase->u_WriteBuffer < count);
+        CHECK(LE32(*UnicamBase->u_DLAddressWord) == (0xc0000000 | unicam_display_address(UnicamBase)));
+
+        for (int i = 0; i < 4; i++)
+        {
+            ULONG frame = sim_frames();
+            UBYTE shown;
+
+            L_UnicamWaitFrame(UnicamBase);
+            shown = UnicamBase->u_DisplayBuffer;
+
+            CHECK(shown < count);
+            CHECK(LE32(*UnicamBase->u_DLAddressWord) == (0xc0000000 | (ULONG)UnicamBase->u_Buffers[shown]));
+            CHECK(frame_matches(UnicamBase, UnicamBase->u_Buffers[shown], frame));
+        }
+
+        sim_reset_counts();
+        UnicamBase->u_MmioReads = 0;
+        UnicamBase->u_MmioWrites = 0;
+    }
+
+    /* Capture window follows the crop rectangle from the next vertical blank on */
+    UnicamBase->u_Window = TRUE;
+    L_UnicamSetCropSize(640, 480, UnicamBase);
+    L_UnicamSetCropOffset(40, 48, UnicamBase);
+    counts("UnicamSetCrop", UnicamBase, 0);
+
+    sim_tick();
+    CHECK(sim_csi_reg(UNICAM_IHWIN) == (((40 + 640) * 3 - 1) << 16 | 40 * 3));
+    CHECK(sim_csi_reg(UNICAM_IVWIN) == ((48 + 480 - 1) << 16 | 48));
+
+    ULONG frame = sim_frames();
+    L_UnicamWaitFrame(UnicamBase);
+    CHECK(frame_matches(UnicamBase, UnicamBase->u_Buffers[UnicamBase->u_DisplayBuffer], frame));
+    counts("window, 2 frames", UnicamBase, 2);
+
+    /*
+        Frame start and end seen by separate polls, with a poll between the end and the next start.
+        The buffer on screen is never the one being written and always holds a complete frame.
+    */
+    L_UnicamSetBuffers(2, UnicamBase);
+    sim_tick();
+
+    for (int i = 0; i < 6; i++)
+    {
+        sim_frame_end();
+        frame = sim_frames() - 1;
+        host_run_vblank();
+        CHECK(frame_matches(UnicamBase, UnicamBase->u_Buffers[UnicamBase->u_DisplayBuffer], frame));
+
+        host_run_vblank();
+        sim_frame_start();
+        CHECK(sim_write_address() != (ULONG)UnicamBase->u_Buffers[UnicamBase->u_DisplayBuffer]);
+
+        host_run_vblank();
+        CHECK(sim_write_address() != (ULONG)UnicamBase->u_Buffers[UnicamBase->u_DisplayBuffer]);
+    }
+
+    /* A frame between two polls is not shown, the next one is captured into its buffer again */
+    sim_frame_end();
+    host_run_vblank();
+    UBYTE shown = UnicamBase->u_DisplayBuffer;
+
+    sim_frame_start();
+    sim_frame_end();
+    host_run_vblank();
+    CHECK(UnicamBase->u_DisplayBuffer == shown);
+    sim_frame_start();
+    CHECK(sim_write_address() != (ULONG)UnicamBase->u_Buffers[shown]);
+
+    /* The frame started meanwhile went to that buffer too and is not shown either */
+    L_UnicamWaitFrame(UnicamBase);
+    CHECK(UnicamBase->u_DisplayBuffer == shown);
+
+    frame = sim_frames();
+    L_UnicamWaitFrame(UnicamBase);
+    CHECK(frame_matches(UnicamBase, UnicamBase->u_Buffers[UnicamBase->u_DisplayBuffer], frame));
+
+    sim_reset_counts();
+    UnicamBase->u_MmioReads = 0;
+    UnicamBase->u_MmioWrites = 0;
+
+    /* An unregistered plane is left alone */
+    L_UnicamUnregisterDL(UnicamBase);
+    ULONG word = *UnicamBase->u_DLLastAddress;
+    L_UnicamWaitFrame(UnicamBase);
+    CHECK(*UnicamBase->u_DLLastAddress == word);
+    counts("UnicamUnregisterDL", UnicamBase, 0);
+
+    /* Source gone: waiting gives up after a few frame periods and grabs fail, until it is back */
+    UBYTE *grab = AllocMem(WIDTH * HEIGHT * 3, MEMF_ANY);
+
+    sim_source.ss_Enabled = FALSE;
+    CHECK(L_UnicamWaitFrame(UnicamBase) == UNICAM_WAIT_TIMEOUT);
+    CHECK(L_UnicamGrabFrame(grab, UNICAM_GRAB_RGB24, NULL, UnicamBase) == 0);
+    sim_source.ss_Enabled = TRUE;
+    CHECK(L_UnicamWaitFrame(UnicamBase) != UNICAM_WAIT_TIMEOUT);
+    CHECK(L_UnicamGrabFrame(grab, UNICAM_GRAB_RGB24, NULL, UnicamBase) == 640 * 480 * 3);
+
+    sim_reset_counts();
+    UnicamBase->u_MmioReads = 0;
+    UnicamBase->u_MmioWrites = 0;
+
+    L_UnicamStop(UnicamBase);
+    counts("UnicamStop", UnicamBase, 0);
+
+    CHECK(!UnicamBase->u_Running && host_int_servers() == 0);
+    CHECK(sim_csi_reg(UNICAM_CTRL) & UNICAM_SOE);
+    CHECK(!(sim_csi_reg(UNICAM_CTRL) & UNICAM_CPE));
+    CHECK((host_mmio_read((volatile ULONG *)SIM_CSI1_CLKGATE) & 0xff) == 0);
+
+    /* Nothing arrives any more, waiting returns at once */
+    frame = sim_frames();
+    CHECK(L_UnicamWaitFrame(UnicamBase) == UnicamBase->u_FrameSequence);
+    sim_tick();
+    CHECK(sim_frames() == frame);
+
+    /* Buffer count alone never moves the framebuffer */
+    APTR framebuffer = L_UnicamGetFramebuffer(UnicamBase);
+
+    L_UnicamSetBuffers(1, UnicamBase);
+    L_UnicamSetBuffers(3, UnicamBase);
+    CHECK(L_UnicamGetFramebuffer(UnicamBase) == framebuffer);
+
+    /*
+        Start with larger frames grows it. The old block stays while the plane built last shows it,
+        and goes once a new plane is built and the HVS had time to leave the old one.
+    */
+    L_UnicamStart(framebuffer, 2, CSI_DT_RGB888, WIDTH, HEIGHT + 64, 24, UnicamBase);
+    CHECK(L_UnicamGetFramebuffer(UnicamBase) != framebuffer);
+    CHECK(UnicamBase->u_CaptureAddress == L_UnicamGetFramebuffer(UnicamBase));
+    CHECK(UnicamBase->u_ActiveBuffers == 3);
+    CHECK(UnicamBase->u_RetiredAlloc != NULL);
+
+    for (int i = 0; i < 5; i++)
+    {
+        L_UnicamWaitFrame(UnicamBase);
+        L_UnicamSetBuffers(3, UnicamBase);
+    }
+    CHECK(UnicamBase->u_RetiredAlloc != NULL);
+
+    /* Time capture was stopped does not count as dropped frames */
+    struct UnicamStats stats;
+
+    framestats_compute(&UnicamBase->u_FrameStats, &stats);
+    CHECK(stats.us_Frames != 0 && stats.us_Frames <= 5 && stats.us_Dropped == 0);
+
+    L_UnicamConstructDL((ULONG *)dlist, DL_OFFSET, UnicamBase);
+    L_UnicamSetBuffers(3, UnicamBase);
+    L_UnicamWaitFrame(UnicamBase);
+    L_UnicamSetBuffers(3, UnicamBase);
+    CHECK(UnicamBase->u_RetiredAlloc != NULL);
+
+    L_UnicamWaitFrame(UnicamBase);
+    L_UnicamWaitFrame(UnicamBase);
+    L_UnicamStop(UnicamBase);
+    CHECK(UnicamBase->u_RetiredAlloc == NULL);
+
+    /* Every public call has given the capture lock back */
+    CHECK(UnicamBase->u_Lock.ss_NestCount == 0);
+
+    host_golden_text("sim_mmio.txt");
+
+    return host_failures();
+}